@@ -0,0 +1,20 @@
+program ar;
+var
+	s, t, u, v, w, x, i, j: integer;
+begin
+	s := 0;
+	t := 0;
+	u := 0;
+	v := 7;
+	w := 0;
+	for i := 1 to 4000 do begin
+		for j := (0 - 500) to 499 do begin
+			x := ((i * 1000) + j);
+			s := (s + (x div 10));
+			t := (t + (x - ((x div 10) * 10)));
+			u := (u + ((x * 9) div 7));
+			v := (((v * 5) + (x div 4)) and 65535);
+			w := (w + ((x * 12) div (0 - 3)));
+		end;
+	end;
+end.
@@ -0,0 +1,61 @@
+#!/bin/bash
+# Run time of code with multiplication and division by constants: arith.p is
+# a 4000 x 1000 loop of 'div' and '*' by 10, 4, 7, -3, 9, 12 and 5.
+#
+# usage: bench/arith/run.sh [REVISION...]
+#
+# Builds the compiler from sources/ and from the sources of every given git
+# revision, compiles arith.p at $LEVEL (default -O2) for the 32-bit target,
+# links it with as/ld and prints the best of $RUNS (default 25) runs with the
+# lines of the assembly.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+work=${WORK:-$(mktemp -d)}
+cxx=${CXX:-g++}
+level=${LEVEL:--O2}
+runs=${RUNS:-25}
+
+# _main ends with 'leave; ret', it's entered with a frame like from a call
+cat > "$work/start.S" <<'END'
+.text
+.global _start
+_enter:
+pushl %ebp
+movl %esp, %ebp
+jmp _main
+_start:
+call _enter
+movl $1, %eax
+xorl %ebx, %ebx
+int $0x80
+END
+
+bench() { # bench SOURCE_DIR NAME
+    local dir="$work/run"
+    rm -rf "$dir"
+    mkdir -p "$dir"
+    $cxx -std=c++17 -O2 "$1"/*.cpp -o "$dir/pc"
+    cp "$here/arith.p" "$dir/test.p"
+    (cd "$dir" && ./pc $level > /dev/null && cat ar.S "$work/start.S" > p.S \
+        && as --32 p.S -o p.o && ld -m elf_i386 p.o -o p)
+
+    local best=
+    for _ in $(seq "$runs"); do
+        local start=$(date +%s%N)
+        "$dir/p"
+        local us=$((($(date +%s%N) - start) / 1000))
+        [ -z "$best" ] || [ $us -lt $best ] && best=$us
+    done
+    printf '%-14s %d.%03d ms, %d lines of assembly\n' "$2" $((best / 1000)) $((best % 1000)) \
+        $(wc -l < "$dir/ar.S")
+}
+
+bench "$repo/sources" "working tree"
+for rev in "$@"; do
+    rm -rf "$work/rev"
+    mkdir -p "$work/rev"
+    git -C "$repo" archive "$rev" sources | tar -x -C "$work/rev"
+    bench "$work/rev/sources" "$rev"
+done
@@ -0,0 +1,78 @@
+// Code generation benchmark: best of RUNS compiles of PROGRAM at an
+// optimization level, the whole compile and GenCode::GenerateAsm() alone.
+//
+// usage: codegen_bench PROGRAM [LEVEL] [RUNS]
+//
+// The output of the parser is dropped, but the parser still walks its tree
+// dump, most of the front-end time. The .S file is written to the current
+// directory like the compiler does and its lines are counted after the runs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "Course_project.h"
+
+using clock_type = std::chrono::steady_clock;
+
+static double msSince(clock_type::time_point t_start)
+{
+    return std::chrono::duration<double, std::milli>(clock_type::now() - t_start).count();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " PROGRAM [LEVEL] [RUNS]" << std::endl;
+        return 2;
+    }
+    int level = (argc > 2) ? std::atoi(argv[2]) : 0;
+    int runs = (argc > 3) ? std::atoi(argv[3]) : 5;
+
+    double best_total = 1e30, best_gen = 1e30;
+    std::string asm_file;
+    for (int i = 0; i < runs; i++) {
+        auto* out = std::cout.rdbuf(nullptr);
+        auto start = clock_type::now();
+
+        Lexer lex(argv[1]);
+        auto syntx = std::make_unique<Syntax>(lex.ScanCode());
+        auto* tree = syntx->ParseCode();
+        if (tree == nullptr) {
+            std::cout.rdbuf(out);
+            std::cerr << "<E> Invalid syntax tree" << std::endl;
+            return 1;
+        }
+        if (level > 0) {
+            ConstFolder folder(syntx->GetArena());
+            folder.Fold(tree);
+        }
+        FlatTree ast(tree);
+        asm_file = std::string(tree->GetValue()) + ".S";
+
+        auto gen_start = clock_type::now();
+        {
+            GenCode gencod(std::move(ast), syntx->GetSymbols(), level);
+            gencod.GenerateAsm();
+        }
+        auto gen_ms = msSince(gen_start);
+        auto total_ms = msSince(start);
+        std::cout.rdbuf(out);
+
+        best_gen = std::min(best_gen, gen_ms);
+        best_total = std::min(best_total, total_ms);
+    }
+
+    std::cout.width(0); // the parser leaves its banner width on std::cout
+    std::cout.fill(' ');
+
+    std::ifstream code(asm_file);
+    size_t lines = std::count(std::istreambuf_iterator<char>(code), std::istreambuf_iterator<char>(), '\n');
+    std::cout << "-O" << level << ": " << lines << " lines, best of " << runs << std::endl;
+    std::cout << "  compile:       " << best_total << " ms" << std::endl;
+    std::cout << "  GenerateAsm(): " << best_gen << " ms  (" << lines / best_gen / 1000.0 << " M lines/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Write a large random program for the code generation benchmark.
+
+usage: gen_program.py OUT [STATEMENTS]
+
+Statements are assignments of random expressions, if-else and nested for
+loops over ten integers and an array; an if counts as three statements.
+The default of 1M statements gives about 1.3M lines (40 MB). The seed is
+fixed, so every run writes the same program.
+
+A loop variable is sometimes assigned in its loop, so a loop may not end.
+Variables start at zero and the program reads nothing, so from -O1 on the
+constant propagation of SSA finds the first endless loop (about 1800 loops
+in) and drops the code after it. -O0 emits all of the code, and so did
+every level before the SSA form.
+"""
+import random
+import sys
+
+VARS = ["a", "b", "c", "d", "e", "f"]
+LOOP_VARS = ["i", "j", "k", "m"]
+
+
+def expr(depth, names):
+    if depth <= 0 or random.random() < 0.3:
+        r = random.random()
+        if r < 0.5:
+            return ("v", random.choice(names))
+        if r < 0.6:
+            return ("arr", random.randint(0, 9))
+        return ("c", random.randint(0, 40))
+    op = random.choice(["+", "-", "*", "div", "and", "or", "xor"])
+    left = expr(depth - 1, names)
+    right = expr(depth - 1, names)
+    if op == "div":
+        right = ("op", "or", right, ("c", 1))   # never divides by zero
+    return ("op", op, left, right)
+
+
+def small(names):
+    r = random.random()
+    if r < 0.4:
+        return ("c", random.randint(0, 5))
+    if r < 0.7:
+        return ("op", "and", ("v", random.choice(names)), ("c", random.choice([3, 7])))
+    return ("op", "and", expr(2, names), ("c", 7))
+
+
+def stmt(depth, loops, names):
+    r = random.random()
+    if r < 0.45 or depth <= 0:
+        target = random.choice(VARS + ["arr"] + (loops if random.random() < 0.05 else []))
+        target = ("arr", random.randint(0, 9)) if target == "arr" else ("v", target)
+        return ("asg", target, expr(3, names))
+    if r < 0.6:
+        cond = (random.choice([">", "<", "<>", ">=", "<="]), expr(2, names), expr(2, names))
+        return ("if", cond, ("asg", ("v", random.choice(VARS)), expr(2, names)),
+                ("asg", ("v", random.choice(VARS)), expr(2, names)))
+    if r < 0.9 and len(loops) < 5:
+        free = [x for x in LOOP_VARS if x not in loops]
+        var = random.choice(free) if free and random.random() < 0.85 else random.choice(VARS + LOOP_VARS)
+        body = [stmt(depth - 1, loops + [var], names + [var]) for _ in range(random.randint(1, 3))]
+        return ("for", var, random.random() < 0.35, small(names), small(names), body)
+    return ("blk", [stmt(depth - 1, loops, names) for _ in range(random.randint(1, 2))])
+
+
+def src_e(e):
+    if e[0] == "v":
+        return e[1]
+    if e[0] == "arr":
+        return "arr[%d]" % e[1]
+    if e[0] == "c":
+        return str(e[1])
+    return "(%s %s %s)" % (src_e(e[2]), e[1], src_e(e[3]))
+
+
+def src_s(s):
+    if s[0] == "asg":
+        return "%s := %s;\n" % (src_e(s[1]), src_e(s[2]))
+    if s[0] == "if":
+        c = s[1]
+        return "begin\nif %s %s %s then %s else %s end;\n" % (
+            src_e(c[1]), c[0], src_e(c[2]), src_s(s[2]).strip().rstrip(";"), src_s(s[3]))
+    if s[0] == "for":
+        return "for %s := %s %s %s do begin\n%send;\n" % (
+            s[1], src_e(s[3]), "downto" if s[2] else "to", src_e(s[4]), "".join(map(src_s, s[5])))
+    return "begin\n%send;\n" % "".join(map(src_s, s[1]))
+
+
+def count(s):
+    if s[0] == "asg":
+        return 1
+    if s[0] == "if":
+        return 3
+    if s[0] == "for":
+        return 1 + sum(map(count, s[5]))
+    return sum(map(count, s[1]))
+
+
+def main():
+    out = sys.argv[1]
+    n = int(sys.argv[2]) if len(sys.argv) > 2 else 1000000
+    random.seed(1)
+
+    parts = ["program big;\nvar\n\ta, b, c, d, e, f, i, j, k, m: integer;\n"
+             "\tarr: array [0..9] of integer;\nbegin\n"]
+    k = 0
+    while k < n:
+        s = stmt(2, [], VARS)
+        k += count(s)
+        parts.append(src_s(s))
+    parts.append("end.\n")
+    with open(out, "w") as f:
+        f.write("".join(parts))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,43 @@
+#!/bin/bash
+# Code generation benchmark on a generated program of 1M statements.
+#
+# usage: bench/codegen/run.sh [REVISION...]
+#
+# Builds codegen_bench against sources/ and against the sources of every
+# given git revision (the GenCode interface it uses exists since the x86-64
+# target was added), then times each of them at the levels of $LEVELS
+# (default "0 1 2"). $STATEMENTS changes the size of the program.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+work=${WORK:-$(mktemp -d)}
+cxx=${CXX:-g++}
+flags="-std=c++17 -O2 -DNDEBUG"
+levels=${LEVELS:-0 1 2}
+
+program="$work/big.p"
+[ -f "$program" ] || python3 "$here/gen_program.py" "$program" ${STATEMENTS:-1000000}
+
+build() { # build OUT SOURCE_DIR
+    $cxx $flags -I"$2" "$here/codegen_bench.cpp" \
+        $(ls "$2"/*.cpp | grep -v '/main\.cpp$') -o "$1"
+}
+
+bench() { # bench BINARY NAME
+    echo "== $2"
+    for level in $levels; do
+        (cd "$work" && "$1" "$program" "$level")
+    done
+}
+
+build "$work/codegen_bench" "$repo/sources"
+bench "$work/codegen_bench" "working tree"
+
+for rev in "$@"; do
+    rm -rf "$work/rev"
+    mkdir -p "$work/rev"
+    git -C "$repo" archive "$rev" sources | tar -x -C "$work/rev"
+    build "$work/codegen_bench_rev" "$work/rev/sources"
+    bench "$work/codegen_bench_rev" "$rev"
+done
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""Write a file of identifiers and keywords for the keyword lookup benchmark.
+
+usage: gen_words.py OUT [WORDS] [KEYWORD_PERCENT]
+
+Defaults are 2M words with 40% keywords, about 10 MB. Words are separated by
+spaces and line breaks, so the file is also valid input for Lexer::ScanCode().
+"""
+import random
+import string
+import sys
+
+KEYWORDS = [
+    "program", "var", "begin", "integer", "boolean", "array", "of", "end",
+    "div", "and", "or", "xor", "if", "for", "to", "downto", "do", "false",
+    "true", "break", "then", "else",
+]
+FIRST = string.ascii_letters
+REST = string.ascii_letters + string.digits
+
+
+def identifier(rng):
+    while True:
+        word = rng.choice(FIRST) + "".join(rng.choice(REST) for _ in range(rng.randint(1, 7)))
+        if word not in KEYWORDS:
+            return word
+
+
+def main():
+    out = sys.argv[1]
+    words = int(sys.argv[2]) if len(sys.argv) > 2 else 2000000
+    percent = int(sys.argv[3]) if len(sys.argv) > 3 else 40
+    rng = random.Random(1)
+
+    with open(out, "w") as f:
+        line = []
+        for _ in range(words):
+            line.append(rng.choice(KEYWORDS) if rng.randrange(100) < percent else identifier(rng))
+            if len(line) == 12:
+                f.write(" ".join(line) + "\n")
+                line = []
+        if line:
+            f.write(" ".join(line) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,139 @@
+// Keyword lookup benchmark: times the if-chain the lexer used to classify
+// identifiers with, the perfect hash of Keywords.h and a whole ScanCode() run.
+//
+// usage: keyword_bench WORDS_FILE [RUNS]
+//
+// Built with -DSCAN_ONLY it only times ScanCode(), so it can be linked with
+// sources of an older revision that have no Keywords.h (see run.sh).
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Lexer.h"
+#ifndef SCAN_ONLY
+#include "Keywords.h"
+#endif
+
+// best of t_runs in milliseconds
+static double bestOf(int t_runs, const std::function<void()>& t_body)
+{
+    double best = 1e30;
+    for (int i = 0; i < t_runs; i++) {
+        auto start = std::chrono::steady_clock::now();
+        t_body();
+        auto stop = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+    return best;
+}
+
+static void report(const char* t_name, double t_ms, size_t t_count, const char* t_unit)
+{
+    std::cout << t_name << t_ms << " ms  (" << t_count / t_ms / 1000.0 << " M " << t_unit << "/s)" << std::endl;
+}
+
+#ifndef SCAN_ONLY
+// the keyword check of Lexer::GetLex before the perfect hash
+static tokens ifChain(std::string_view lex)
+{
+    if (lex == "program")       { return program_tk; }
+    else if (lex == "var")      { return var_tk; }
+    else if (lex == "begin")    { return begin_tk; }
+    else if (lex == "integer")  { return type_tk; }
+    else if (lex == "boolean")  { return type_tk; }
+    else if (lex == "array")    { return arr_tk; }
+    else if (lex == "of")       { return of_tk; }
+    else if (lex == "end")      { return end_tk; }
+    else if (lex == "div")      { return div_tk; }
+    else if (lex == "and")      { return and_tk; }
+    else if (lex == "or")       { return or_tk; }
+    else if (lex == "xor")      { return xor_tk; }
+    else if (lex == "if")       { return if_tk; }
+    else if (lex == "for")      { return for_tk; }
+    else if (lex == "to")       { return to_tk; }
+    else if (lex == "downto")   { return downto_tk; }
+    else if (lex == "do")       { return do_tk; }
+    else if (lex == "false")    { return bool_false_tk; }
+    else if (lex == "true")     { return bool_true_tk; }
+    else if (lex == "break")    { return break_tk; }
+    else if (lex == "then")     { return then_tk; }
+    else if (lex == "else")     { return else_tk; }
+    return id_tk;
+}
+
+static std::vector<std::string_view> splitWords(const std::string& t_text)
+{
+    std::vector<std::string_view> words;
+    size_t i = 0;
+    while (i < t_text.size()) {
+        if (!std::isalpha(static_cast<unsigned char>(t_text[i]))) {
+            i++;
+            continue;
+        }
+        auto start = i;
+        while (i < t_text.size() && std::isalnum(static_cast<unsigned char>(t_text[i])))
+            i++;
+        words.emplace_back(t_text.data() + start, i - start);
+    }
+    return words;
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " WORDS_FILE [RUNS]" << std::endl;
+        return 2;
+    }
+    const char* path = argv[1];
+    int runs = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "<E> Can't open " << path << std::endl;
+        return 1;
+    }
+
+#ifndef SCAN_ONLY
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    auto words = splitWords(text);
+    size_t keyword_count = 0;
+    for (auto word : words)
+        keyword_count += (FindKeyword(word.data(), word.size()) != id_tk);
+    std::cout << words.size() << " words, " << keyword_count << " keywords, "
+              << text.size() << " bytes, best of " << runs << std::endl;
+
+    // the sums keep the compiler from dropping the lookups
+    size_t chain_sum = 0, hash_sum = 0;
+    auto chain_ms = bestOf(runs, [&] {
+        for (auto word : words)
+            chain_sum += ifChain(word);
+    });
+    auto hash_ms = bestOf(runs, [&] {
+        for (auto word : words)
+            hash_sum += FindKeyword(word.data(), word.size());
+    });
+    if (chain_sum != hash_sum) {
+        std::cerr << "<E> If-chain and perfect hash disagree" << std::endl;
+        return 1;
+    }
+    report("if-chain lookup:     ", chain_ms, words.size(), "words");
+    report("perfect hash lookup: ", hash_ms, words.size(), "words");
+#endif
+
+    size_t lexemes = 0;
+    auto scan_ms = bestOf(runs, [&] {
+        Lexer lex(path);
+        lexemes = lex.ScanCode().size();
+    });
+    report("ScanCode():          ", scan_ms, lexemes, "lexemes");
+    return 0;
+}
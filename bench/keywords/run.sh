@@ -0,0 +1,39 @@
+#!/bin/bash
+# Keyword lookup benchmark.
+#
+# usage: bench/keywords/run.sh [REVISION...]
+#
+# Generates the word file (2M words, 40% keywords), builds keyword_bench
+# against sources/ and runs it. ScanCode() of every given git REVISION is
+# timed as well, e.g. "db4d6b5~1 db4d6b5" for the if-chain and the first
+# perfect hash lexer.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+work=${WORK:-$(mktemp -d)}
+cxx=${CXX:-g++}
+flags="-std=c++17 -O2 -DNDEBUG"
+
+words="$work/words.txt"
+[ -f "$words" ] || python3 "$here/gen_words.py" "$words"
+
+build() { # build OUT SOURCE_DIR [EXTRA FLAGS]
+    local out=$1 src=$2
+    shift 2
+    $cxx $flags "$@" -I"$src" "$here/keyword_bench.cpp" \
+        $(ls "$src"/*.cpp | grep -v '/main\.cpp$') -o "$out"
+}
+
+build "$work/keyword_bench" "$repo/sources"
+echo "== working tree"
+"$work/keyword_bench" "$words"
+
+for rev in "$@"; do
+    rm -rf "$work/rev"
+    mkdir -p "$work/rev"
+    git -C "$repo" archive "$rev" sources | tar -x -C "$work/rev"
+    build "$work/keyword_bench_rev" "$work/rev/sources" -DSCAN_ONLY
+    echo "== $rev"
+    "$work/keyword_bench_rev" "$words"
+done
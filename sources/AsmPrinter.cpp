@@ -0,0 +1,147 @@
+#include "AsmPrinter.h"
+
+// in order of Opcode, instructions with operands end with space
+const std::array<std::string_view, AsmPrinter::OPCODE_COUNT> AsmPrinter::MNEMONICS = {
+    "movl ", "addl ", "subl ", "imull ", "andl ", "orl ", "xorl ", "cmpl ", "idivl ", "cltd",
+    "shll ", "sarl ", "shrl ", "negl ", "leal ",
+    "xchgl ", "pushl ", "popl ",
+    "movzbl ", "movb ",
+    "sete ", "setne ", "setl ", "setle ", "setg ", "setge ",
+    "cmove ", "cmovne ", "cmovl ", "cmovle ", "cmovg ", "cmovge ",
+    "jmp ", "je ", "jne ", "jl ", "jle ", "jg ", "jge ", "ja ",
+    "leave", "ret", "ud2",
+    "", "", "", "",
+};
+
+const std::array<std::string_view, AsmPrinter::OPCODE_COUNT> AsmPrinter::WIDE_MNEMONICS = {
+    "movq ", "addq ", "subq ", "imulq ", "andq ", "orq ", "xorq ", "cmpq ", "idivq ", "cqto",
+    "shlq ", "sarq ", "shrq ", "negq ", "leaq ",
+    "xchgq ", "pushq ", "popq ",
+    "movzbq ", "movb ",
+    "sete ", "setne ", "setl ", "setle ", "setg ", "setge ",
+    "cmove ", "cmovne ", "cmovl ", "cmovle ", "cmovg ", "cmovge ",
+    "jmp ", "je ", "jne ", "jl ", "jle ", "jg ", "jge ", "ja ",
+    "leave", "ret", "ud2",
+    "", "", "", "",
+};
+
+
+AsmPrinter::AsmPrinter(const Target& t_target)
+    : target(t_target) {}
+
+
+/**
+ * @brief Append lines of the code to the buffer
+ * @param[in]  t_code - instructions
+ * @param[out] t_out  - text of GAS
+ *
+ * @return none
+ */
+void AsmPrinter::Print(const MachineCode& t_code, Emitter& t_out) const {
+    for (size_t i = 0; i < t_code.size(); i++) {
+        auto& instr = t_code[i];
+        switch (instr.op) {
+        case Opcode::label:
+            putLabel(t_out, t_code, instr.src);
+            t_out << ':';
+            break;
+        case Opcode::data:
+            t_out << t_code.GetName(instr.src.name) << ": " << t_code.GetName(instr.text);
+            if (instr.dst.kind != Operand::imm)
+                break;
+            if (instr.dst.name == 0)
+                t_out << instr.dst.value;
+            else
+                t_out << t_code.GetName(instr.dst.name);
+            break;
+        case Opcode::directive:
+            t_out << t_code.GetName(instr.text);
+            break;
+        case Opcode::separator:
+            t_out << ' ';
+            break;
+        default:
+            t_out << (instr.wide ? WIDE_MNEMONICS : MNEMONICS)[static_cast<size_t>(instr.op)];
+            if (instr.src.kind == Operand::reg && MachineCode::IsByteSource(instr.op))
+                t_out << Target::GetByteName(instr.src.r);
+            else if (instr.src.kind != Operand::none)
+                putOperand(t_out, t_code, instr.src, instr.wide);
+            if (instr.dst.kind != Operand::none) {
+                t_out << ", ";
+                putOperand(t_out, t_code, instr.dst, instr.wide);
+            }
+            break;
+        }
+        t_out.EndLine();
+    }
+}
+
+
+/**
+ * @brief Put operand of instruction
+ * @param[out] t_out  - text of GAS
+ * @param[in]  t_code - code with names of operands
+ * @param[in]  t_op   - operand
+ * @param[in]  t_wide - registers are 64-bit
+ *
+ * @return none
+ * @note Base register of address is a word of the target
+ */
+void AsmPrinter::putOperand(Emitter& t_out, const MachineCode& t_code, const Operand& t_op, bool t_wide) const {
+    switch (t_op.kind) {
+    case Operand::reg:
+        t_out << Target::GetRegName(t_op.r, t_wide);
+        break;
+    case Operand::imm:
+        t_out << '$';
+        if (t_op.name == 0)
+            t_out << t_op.value;
+        else
+            t_out << t_code.GetName(t_op.name);
+        break;
+    case Operand::mem:
+        target.PutMemory(t_out, t_code.GetName(t_op.name), t_op.value);
+        if (t_op.HasIndex())
+            t_out << "(, " << Target::GetRegName(t_op.GetIndex(), false) << ", " << t_op.GetScale() << ')';
+        break;
+    case Operand::address:
+        if (t_op.value != 0)
+            t_out << t_op.value;
+        t_out << '(' << Target::GetRegName(t_op.r, target.IsWide());
+        if (t_op.HasIndex())
+            t_out << ", " << Target::GetRegName(t_op.GetIndex(), target.IsWide()) << ", " << t_op.GetScale();
+        t_out << ')';
+        break;
+    case Operand::label:
+        putLabel(t_out, t_code, t_op);
+        break;
+    default:
+        break;
+    }
+}
+
+
+void AsmPrinter::putLabel(Emitter& t_out, const MachineCode& t_code, const Operand& t_label) const {
+    switch (t_label.label_kind) {
+    case LabelKind::name:
+        t_out << t_code.GetName(t_label.name);
+        if (t_label.value != 0)
+            t_out << '_' << t_label.value;
+        break;
+    case LabelKind::block:
+        t_out << "_bb" << t_label.value << '_';
+        break;
+    case LabelKind::nope:
+        t_out << "_nope" << t_label.value << '_';
+        break;
+    case LabelKind::end:
+        t_out << "_end" << t_label.value << '_';
+        break;
+    case LabelKind::loop:
+        t_out << "_for" << t_label.value << '_';
+        break;
+    case LabelKind::loop_done:
+        t_out << "_for" << t_label.value << "_done_";
+        break;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef ASMPRINTER_H
+#define ASMPRINTER_H
+
+#include <array>
+#include <string_view>
+#include "Emitter.h"
+#include "MachineCode.h"
+#include "Target.h"
+
+/*
+ * Text of GAS for instructions of MachineCode. Operations get 'l' or 'q'
+ * suffix by their width, memory operands and the registers of addresses
+ * are named by the target.
+ */
+class AsmPrinter
+{
+public:
+	explicit AsmPrinter(const Target& t_target);
+
+	void	Print(const MachineCode& t_code, Emitter& t_out) const;
+
+private:
+	using Operand = MachineCode::Operand;
+
+	static constexpr size_t OPCODE_COUNT = static_cast<size_t>(Opcode::separator) + 1;
+	static const std::array<std::string_view, OPCODE_COUNT> MNEMONICS;		// with 'l' and space
+	static const std::array<std::string_view, OPCODE_COUNT> WIDE_MNEMONICS;	// with 'q' and space
+
+	const Target&	target;
+
+	void	putOperand(Emitter& t_out, const MachineCode& t_code, const Operand& t_op, bool t_wide) const;
+	void	putLabel(Emitter& t_out, const MachineCode& t_code, const Operand& t_label) const;
+};
+
+#endif // !ASMPRINTER_H
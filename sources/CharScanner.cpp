@@ -0,0 +1,233 @@
+#include "CharScanner.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SCAN_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SCAN_TARGET(isa)
+#endif
+
+
+/*** Scalar implementation ***/
+
+static inline bool isSpace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+}
+
+static inline bool isDigit(char ch) {
+    return static_cast<unsigned>(static_cast<unsigned char>(ch) - '0') < 10u;
+}
+
+static inline bool isIdent(char ch) {
+    auto lo = static_cast<unsigned>(static_cast<unsigned char>(ch) | 0x20); // fold case of letters
+    return (lo - 'a') < 26u || isDigit(ch);
+}
+
+static const char* skipSpacesScalar(const char* t_pos, int& t_lines) {
+    while (isSpace(*t_pos)) {
+        if (*t_pos == '\n') t_lines++;
+        t_pos++;
+    }
+    return t_pos;
+}
+
+static const char* skipIdentScalar(const char* t_pos) {
+    while (isIdent(*t_pos)) t_pos++;
+    return t_pos;
+}
+
+static const char* skipDigitsScalar(const char* t_pos) {
+    while (isDigit(*t_pos)) t_pos++;
+    return t_pos;
+}
+
+
+#ifdef SCAN_X86
+
+static inline unsigned countZeros(unsigned mask) {  // mask != 0
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return idx;
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+static inline int countBits(unsigned mask) {
+#ifdef _MSC_VER
+    int cnt = 0;
+    for (; mask; mask &= mask - 1) cnt++;
+    return cnt;
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+
+/*** SSE2 implementation, 16 bytes per step ***/
+
+SCAN_TARGET("sse2")
+static const char* skipSpacesSse2(const char* t_pos, int& t_lines) {
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tb = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nl = _mm_set1_epi8('\n');
+
+    for (;;) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_pos));
+        __m128i is_nl = _mm_cmpeq_epi8(v, nl);
+        __m128i is_ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tb)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(v, cr), is_nl));
+        auto stop = ~static_cast<unsigned>(_mm_movemask_epi8(is_ws)) & 0xFFFFu;
+        auto lines = static_cast<unsigned>(_mm_movemask_epi8(is_nl));
+
+        if (stop != 0) {
+            auto idx = countZeros(stop);
+            t_lines += countBits(lines & ((1u << idx) - 1));
+            return t_pos + idx;
+        }
+        t_lines += countBits(lines);
+        t_pos += 16;
+    }
+}
+
+SCAN_TARGET("sse2")
+static inline __m128i digitMaskSse2(__m128i v) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+}
+
+SCAN_TARGET("sse2")
+static const char* skipIdentSse2(const char* t_pos) {
+    for (;;) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_pos));
+        __m128i lo = _mm_or_si128(v, _mm_set1_epi8(0x20)); // fold case of letters
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lo, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lo, _mm_set1_epi8('z' + 1)));
+        __m128i ident = _mm_or_si128(alpha, digitMaskSse2(v));
+        auto stop = ~static_cast<unsigned>(_mm_movemask_epi8(ident)) & 0xFFFFu;
+
+        if (stop != 0)
+            return t_pos + countZeros(stop);
+        t_pos += 16;
+    }
+}
+
+SCAN_TARGET("sse2")
+static const char* skipDigitsSse2(const char* t_pos) {
+    for (;;) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_pos));
+        auto stop = ~static_cast<unsigned>(_mm_movemask_epi8(digitMaskSse2(v))) & 0xFFFFu;
+
+        if (stop != 0)
+            return t_pos + countZeros(stop);
+        t_pos += 16;
+    }
+}
+
+
+/*** AVX2 implementation, 32 bytes per step ***/
+
+SCAN_TARGET("avx2")
+static const char* skipSpacesAvx2(const char* t_pos, int& t_lines) {
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tb = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i nl = _mm256_set1_epi8('\n');
+
+    for (;;) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_pos));
+        __m256i is_nl = _mm256_cmpeq_epi8(v, nl);
+        __m256i is_ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tb)),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), is_nl));
+        auto stop = ~static_cast<unsigned>(_mm256_movemask_epi8(is_ws));
+        auto lines = static_cast<unsigned>(_mm256_movemask_epi8(is_nl));
+
+        if (stop != 0) {
+            auto idx = countZeros(stop);
+            t_lines += countBits(lines & ((1u << idx) - 1));
+            return t_pos + idx;
+        }
+        t_lines += countBits(lines);
+        t_pos += 32;
+    }
+}
+
+SCAN_TARGET("avx2")
+static inline __m256i digitMaskAvx2(__m256i v) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+}
+
+SCAN_TARGET("avx2")
+static const char* skipIdentAvx2(const char* t_pos) {
+    for (;;) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_pos));
+        __m256i lo = _mm256_or_si256(v, _mm256_set1_epi8(0x20)); // fold case of letters
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lo, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lo));
+        __m256i ident = _mm256_or_si256(alpha, digitMaskAvx2(v));
+        auto stop = ~static_cast<unsigned>(_mm256_movemask_epi8(ident));
+
+        if (stop != 0)
+            return t_pos + countZeros(stop);
+        t_pos += 32;
+    }
+}
+
+SCAN_TARGET("avx2")
+static const char* skipDigitsAvx2(const char* t_pos) {
+    for (;;) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_pos));
+        auto stop = ~static_cast<unsigned>(_mm256_movemask_epi8(digitMaskAvx2(v)));
+
+        if (stop != 0)
+            return t_pos + countZeros(stop);
+        t_pos += 32;
+    }
+}
+
+
+static bool cpuHas(bool avx2) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return avx2 ? __builtin_cpu_supports("avx2") : __builtin_cpu_supports("sse2");
+#elif defined(_MSC_VER)
+    int regs[4];
+    if (!avx2) {
+        __cpuid(regs, 1);
+        return (regs[3] & (1 << 26)) != 0;
+    }
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    bool os_avx = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    __cpuidex(regs, 7, 0);
+    return os_avx && (regs[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif // SCAN_X86
+
+
+CharScanner::Impl CharScanner::selectImpl() {
+#ifdef SCAN_X86
+    if (cpuHas(true))
+        return { skipSpacesAvx2, skipIdentAvx2, skipDigitsAvx2, "avx2" };
+    if (cpuHas(false))
+        return { skipSpacesSse2, skipIdentSse2, skipDigitsSse2, "sse2" };
+#endif
+    return { skipSpacesScalar, skipIdentScalar, skipDigitsScalar, "scalar" };
+}
+
+const CharScanner::Impl CharScanner::impl = CharScanner::selectImpl();
@@ -0,0 +1,40 @@
+#ifndef CHAR_SCANNER_H
+#define CHAR_SCANNER_H
+
+#include <cstddef>
+
+/*
+ * Finds the end of whitespace, identifier and digit runs in the source buffer
+ * 16 (SSE2) or 32 (AVX2) bytes at a time. The implementation is picked once at
+ * runtime by the CPU features, plain scalar code is used everywhere else.
+ *
+ * Every run stops on the '\0' sentinel, but the vector code reads whole blocks,
+ * so the buffer must have at least SCAN_PADDING readable bytes after the sentinel.
+ */
+class CharScanner
+{
+public:
+	static constexpr size_t SCAN_PADDING = 32;
+
+	// skip ' ', '\t', '\r', '\n' and count passed '\n' in t_lines
+	static const char*	SkipSpaces(const char* t_pos, int& t_lines) { return impl.skip_spaces(t_pos, t_lines); }
+	// skip [a-zA-Z0-9]
+	static const char*	SkipIdent(const char* t_pos) { return impl.skip_ident(t_pos); }
+	// skip [0-9]
+	static const char*	SkipDigits(const char* t_pos) { return impl.skip_digits(t_pos); }
+
+	static const char*	GetName() { return impl.name; }
+
+private:
+	struct Impl {
+		const char* (*skip_spaces)(const char*, int&);
+		const char* (*skip_ident)(const char*);
+		const char* (*skip_digits)(const char*);
+		const char* name;
+	};
+
+	static const Impl	impl;
+	static Impl			selectImpl();
+};
+
+#endif // !CHAR_SCANNER_H
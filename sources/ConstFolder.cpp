@@ -0,0 +1,255 @@
+#include "ConstFolder.h"
+
+/**
+ * @brief Fold constants of the tree, the walk uses its own stack and doesn't
+ *        depend on the depth of the tree
+ * @param[in] t_root - root of syntax tree
+ *
+ * @return number of nodes eliminated from the tree
+ */
+size_t ConstFolder::Fold(Tree* t_root) {
+    removed = 0;
+    if (t_root == nullptr)
+        return removed;
+
+    TreeArena::Scope scope(arena);
+    std::vector<std::pair<Tree*, bool>> walk;   // node, its children are pushed
+    walk.emplace_back(t_root, false);
+
+    while (!walk.empty()) {
+        auto [tree, expanded] = walk.back();
+        if (!expanded) {
+            walk.back().second = true;
+            if (tree->GetRightNode() != nullptr) walk.emplace_back(tree->GetRightNode(), false);
+            if (tree->GetLeftNode() != nullptr)  walk.emplace_back(tree->GetLeftNode(), false);
+            continue;
+        }
+        walk.pop_back();
+
+        // children are folded already, the node can be replaced in its parent
+        if (tree->GetKind() == NodeKind::operation)
+            foldOperation(tree);
+        else if (tree->GetKind() == NodeKind::if_op)
+            foldIf(tree);
+    }
+
+    return removed;
+}
+
+/**
+ * @brief Compute operator of constants or drop it by identity
+ * @param[in] t_node - node of operator
+ *
+ * @return none
+ * @note x + 0, x - 0, x or 0, x xor 0, x * 1, x div 1 give x;
+ * x * 0, x and 0, x - x, x xor x give 0
+ */
+void ConstFolder::foldOperation(Tree* t_node) {
+    auto* left = t_node->GetLeftNode();
+    auto* right = t_node->GetRightNode();
+    auto op = t_node->GetOperation();
+    if (left == nullptr || right == nullptr)
+        return;
+
+    if (isConstant(left) && isConstant(right)) {
+        auto value = compute(op, left->GetNumber(), right->GetNumber());
+        if (!value)
+            return;
+
+        auto logic = IsComparison(op) ||
+            (left->GetKind() == NodeKind::boolean && right->GetKind() == NodeKind::boolean);
+        replace(t_node, logic ? Tree::CreateNode(NodeKind::boolean, *value ? "true" : "false")
+                              : Tree::CreateNode(NodeKind::constant, std::to_string(*value)));
+        removed += 2;
+        return;
+    }
+
+    auto* constant = isConstant(right) ? right : (isConstant(left) ? left : nullptr);
+    auto* other = (constant == right) ? left : right;
+    auto on_right = (constant == right);
+    auto keep = false;  // operator gives the other operand
+    auto zero = false;  // operator gives 0
+
+    if (constant != nullptr) {
+        auto value = constant->GetNumber();
+        switch (op) {
+        case OpKind::add:
+        case OpKind::or_:
+        case OpKind::xor_:
+            keep = (value == 0);
+            break;
+        case OpKind::sub:
+            keep = (value == 0 && on_right);
+            break;
+        case OpKind::mul:
+            keep = (value == 1);
+            zero = (value == 0);
+            break;
+        case OpKind::div:
+            keep = (value == 1 && on_right);
+            break;
+        case OpKind::and_:
+            zero = (value == 0);
+            break;
+        default:
+            break;
+        }
+    }
+    else if (op == OpKind::sub || op == OpKind::xor_) {
+        zero = isSame(left, right);
+        other = t_node;
+    }
+
+    if (keep) {
+        replace(t_node, other);
+        removed += 2;
+    }
+    else if (zero && !mayFault(other)) {
+        removed += Tree::CountNodes(t_node) - 1;
+        replace(t_node, Tree::CreateNode(NodeKind::constant, "0"));
+    }
+}
+
+/**
+ * @brief Put the taken branch of 'if' with the known condition in place of it
+ * @param[in] t_node - node of 'if'
+ *
+ * @return none
+ * @note 'if' stays when the branch can't be put in its place: 'break' is only
+ * generated in 'then' and 'else', 'for' isn't, body of 'for' can't be empty
+ */
+void ConstFolder::foldIf(Tree* t_node) {
+    auto* cond = t_node->GetLeftNode();
+    auto* then_op = t_node->GetRightNode();
+    auto* parent = t_node->GetParentNode();
+    if (cond == nullptr || then_op == nullptr || parent == nullptr ||
+        cond->GetKind() != NodeKind::boolean)
+        return;
+
+    auto* else_op = then_op->GetRightNode();
+    auto* else_st = (else_op != nullptr) ? else_op->GetLeftNode() : nullptr;
+    auto* taken = (cond->GetNumber() != 0) ? then_op->GetLeftNode() : else_st;
+    auto* dropped = (cond->GetNumber() != 0) ? else_st : then_op->GetLeftNode();
+
+    auto place = parent->GetKind();
+    if (taken == nullptr) {
+        if (place == NodeKind::for_op)
+            return;
+    }
+    else if (taken->GetKind() == NodeKind::break_op) {
+        if (place != NodeKind::then_op && place != NodeKind::else_op)
+            return;
+    }
+    else if (taken->GetKind() == NodeKind::for_op) {
+        if (place == NodeKind::then_op || place == NodeKind::else_op)
+            return;
+    }
+
+    removed += 3 + ((else_op != nullptr) ? 1 : 0) + Tree::CountNodes(dropped); // if, condition, then, else
+    if (taken != nullptr)
+        replace(t_node, taken);
+    else
+        parent->FreeLeftNode(); // statement without operator, only its label is generated
+}
+
+/**
+ * @brief Put the tree in place of the node in its parent
+ * @param[in] t_node - node to replace
+ * @param[in] t_by   - new subtree
+ *
+ * @return none
+ */
+void ConstFolder::replace(Tree* t_node, Tree* t_by) {
+    auto* parent = t_node->GetParentNode();
+    if (parent->GetLeftNode() == t_node)
+        parent->AddLeftTree(t_by);
+    else
+        parent->AddRightTree(t_by);
+}
+
+/**
+ * @brief Compute operator as the generated code does
+ * @param[in] t_op    - operator
+ * @param[in] t_left  - left operand
+ * @param[in] t_right - right operand
+ *
+ * @return value or nothing if it's computed at run time only (division by zero)
+ */
+std::optional<int32_t> ConstFolder::compute(OpKind t_op, int32_t t_left, int32_t t_right) {
+    auto left = static_cast<uint32_t>(t_left);
+    auto right = static_cast<uint32_t>(t_right);
+
+    switch (t_op) {
+    case OpKind::add:  return static_cast<int32_t>(left + right);
+    case OpKind::sub:  return static_cast<int32_t>(left - right);
+    case OpKind::mul:  return static_cast<int32_t>(left * right);
+    case OpKind::and_: return static_cast<int32_t>(left & right);
+    case OpKind::or_:  return static_cast<int32_t>(left | right);
+    case OpKind::xor_: return static_cast<int32_t>(left ^ right);
+    case OpKind::div:  // 'idivl' truncates toward zero
+        if (right == 0)
+            return std::nullopt;
+        return (t_right == -1) ? static_cast<int32_t>(0u - left) : t_left / t_right;
+    case OpKind::eq:   return t_left == t_right;
+    case OpKind::ne:   return t_left != t_right;
+    case OpKind::gt:   return t_left > t_right;
+    case OpKind::lt:   return t_left < t_right;
+    case OpKind::ge:   return t_left >= t_right;
+    case OpKind::le:   return t_left <= t_right;
+    default:
+        return std::nullopt;
+    }
+}
+
+bool ConstFolder::isConstant(Tree* t_node) {
+    return t_node->GetKind() == NodeKind::constant || t_node->GetKind() == NodeKind::boolean;
+}
+
+/**
+ * @brief Compare subtrees of expressions
+ * @param[in] t_left  - first subtree
+ * @param[in] t_right - second subtree
+ *
+ * @return true if they have the same operators and operands
+ */
+bool ConstFolder::isSame(Tree* t_left, Tree* t_right) {
+    std::vector<std::pair<Tree*, Tree*>> walk{ { t_left, t_right } };
+
+    while (!walk.empty()) {
+        auto [left, right] = walk.back();
+        walk.pop_back();
+        if (left == nullptr || right == nullptr) {
+            if (left != right)
+                return false;
+            continue;
+        }
+
+        if (left->GetKind() != right->GetKind() || left->GetOperation() != right->GetOperation() ||
+            left->GetSymbol() != right->GetSymbol())
+            return false;
+
+        walk.emplace_back(left->GetLeftNode(), right->GetLeftNode());
+        walk.emplace_back(left->GetRightNode(), right->GetRightNode());
+    }
+
+    return true;
+}
+
+// subtree has division or index of array which isn't constant
+bool ConstFolder::mayFault(Tree* t_node) {
+    std::vector<Tree*> walk{ t_node };
+
+    while (!walk.empty()) {
+        auto* node = walk.back();
+        walk.pop_back();
+        if (node->GetOperation() == OpKind::div)
+            return true;
+        if (node->GetKind() == NodeKind::array_elem && node->GetRightNode()->GetKind() != NodeKind::constant)
+            return true;
+
+        if (node->GetLeftNode() != nullptr) walk.push_back(node->GetLeftNode());
+        if (node->GetRightNode() != nullptr) walk.push_back(node->GetRightNode());
+    }
+
+    return false;
+}
@@ -0,0 +1,44 @@
+#ifndef CONST_FOLDER_H
+#define CONST_FOLDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "Tree.h"
+#include "TreeArena.h"
+
+/*
+ * Pass over the syntax tree before code generation. Operators of constants are
+ * computed as the code would do it at run time: 32-bit wrapping arithmetic,
+ * signed 'div' and signed comparisons. Identities like x + 0, x * 1, x * 0
+ * and x xor x drop the operator, so an 'if' with a known condition keeps only
+ * the branch which is taken.
+ *
+ * The tree is changed in place, new nodes are taken from the arena of the tree.
+ * Subtrees with 'div' or an element of array by index are never dropped,
+ * division by zero and index out of range stay in the code.
+ */
+class ConstFolder
+{
+public:
+	explicit ConstFolder(TreeArena& t_arena) : arena(t_arena) {};
+
+	size_t		Fold(Tree* t_root);		// returns nodes eliminated from the tree
+
+private:
+	TreeArena&	arena;
+	size_t		removed{ 0 };
+
+	void		foldOperation(Tree* t_node);
+	void		foldIf(Tree* t_node);
+	void		replace(Tree* t_node, Tree* t_by);
+
+	static std::optional<int32_t>	compute(OpKind t_op, int32_t t_left, int32_t t_right);
+	static bool		isConstant(Tree* t_node);
+	static bool		isSame(Tree* t_left, Tree* t_right);
+	static bool		mayFault(Tree* t_node);
+};
+
+#endif // !CONST_FOLDER_H
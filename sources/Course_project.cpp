@@ -1,21 +1,126 @@
-#include "Course_project.h"
-
-
-int Compile(const std::string& file_path) {
-
-	Lexer lex(file_path.c_str());
-	auto table = lex.ScanCode(); //table of lexemes
-
-	Syntax syntx(std::move(table));
-	auto tree = syntx.ParseCode(); // syntax tree
-
-	if (tree == nullptr) {
-		std::cerr << "Error: Invalid syntax tree" << std::endl;
-		return -EXIT_FAILURE;
-	}
-
-	GenCode gencod(std::move(*tree));
-	gencod.GenerateAsm(); // final code file
-
-	return EXIT_SUCCESS;
+#include "Course_project.h"
+
+
+/**
+ * @brief Fold constants of syntax tree and generate assembler code from its
+ *        flat copy
+ * @param[in] tree  - syntax tree
+ * @param[in] syntx - parser of the tree, it keeps nodes and declared variables
+ * @param[in] options - optimization level, target of code and checks of index
+ *
+ * @return none
+ */
+static void generateCode(Tree* tree, const Syntax& syntx, const CompileOptions& options) {
+	auto level = options.opt_level;
+	if (level > 0) {
+		ConstFolder folder(syntx.GetArena());
+		std::cout << "Constant folding removed " << folder.Fold(tree) << " nodes" << std::endl;
+	}
+
+	FlatTree ast(tree);
+	std::cout << "Flat tree takes " << ast.size() << " nodes, " << ast.GetBytes() << " bytes" << std::endl;
+
+	GenCode gencod(std::move(ast), syntx.GetSymbols(), level, options.target, options.bounds_check);
+	gencod.GenerateAsm(); // final code file
+	std::cout << "SSA code has " << gencod.GetSsaValues() << " values, " << gencod.GetSsaPhis()
+		<< " phis in " << gencod.GetSsaBlocks() << " blocks" << std::endl;
+	auto& optimizer = gencod.GetOptimizer();
+	if (level > 0) {
+		std::cout << "SSA passes folded " << optimizer.GetFolded() << " values, "
+			<< optimizer.GetBranches() << " branches, removed " << optimizer.GetDeadBlocks() << " blocks, "
+			<< optimizer.GetCopies() << " copies, " << optimizer.GetDeadValues() << " dead values in "
+			<< optimizer.GetRounds() << " rounds" << std::endl;
+		std::cout << "Loop-invariant code motion hoisted " << optimizer.GetHoisted() << " values" << std::endl;
+		std::cout << "If-conversion turned " << optimizer.GetSelects() << " branches into selects" << std::endl;
+		if (options.bounds_check)
+			std::cout << "Range analysis removed " << optimizer.GetChecks() << " checks of index" << std::endl;
+	}
+	std::cout << "Register allocation spilled " << gencod.GetLowering().GetSpilled() << " values to "
+		<< gencod.GetLowering().GetSlotCount() << " slots" << std::endl;
+	std::cout << "Code has " << gencod.GetStackOps() << " push/pop instructions in "
+		<< gencod.GetBlockCount() << " basic blocks" << std::endl;
+
+	auto& peephole = gencod.GetPeephole();
+	if (level > 0) {
+		std::cout << "Peephole removed " << peephole.GetRemoved() << " instructions in "
+			<< peephole.GetSweeps() << " sweeps" << std::endl;
+		for (size_t i = 0; i < peephole.GetRuleCount(); i++)
+			std::cout << "  " << peephole.GetRuleName(i) << ": " << peephole.GetHits(i) << std::endl;
+	}
+}
+
+/**
+ * @brief Apply edits to the source one by one and rebuild the program after
+ *        each of them from the lexemes and the syntax tree of the last build
+ * @param[in] source - code of the last build
+ * @param[in] syntx  - syntax of the last build
+ * @param[in] options - edits, offsets are in the code after the previous edit,
+ *                      optimization level and target
+ *
+ * @return EXIT_SUCCESS or -EXIT_FAILURE
+ */
+static int rebuildEdited(std::string source, std::unique_ptr<Syntax> syntx,
+						 const CompileOptions& options) {
+	auto result = EXIT_SUCCESS;
+	for (auto& edit : options.edits) {
+		if (static_cast<size_t>(edit.offset) + edit.removed > source.size()) {
+			std::cerr << "<E> Edit is out of the code" << std::endl;
+			return -EXIT_FAILURE;
+		}
+		source.replace(edit.offset, edit.removed, edit.text);
+
+		Lexer lex(source.data(), source.size());
+		TokenDamage damage;
+		auto table = lex.Rescan(syntx->GetLexTable(), edit, damage);
+		auto lexemes = table.size();
+
+		auto next = std::make_unique<Syntax>(std::move(table));
+		auto tree = next->ParseCode(*syntx, damage);
+		syntx = std::move(next);
+
+		if (tree == nullptr) { // the next edit may fix it
+			std::cerr << "Error: Invalid syntax tree" << std::endl;
+			result = -EXIT_FAILURE;
+			continue;
+		}
+
+		std::cout << "Reused " << damage.reused << " of " << lexemes << " lexemes and "
+			<< syntx->GetReusedNodes() << " of " << Tree::CountNodes(tree) << " tree nodes" << std::endl;
+
+		generateCode(tree, *syntx, options);
+		result = EXIT_SUCCESS;
+	}
+
+	return result;
+}
+
+int Compile(const std::string& file_path, const CompileOptions& options) {
+
+	auto streaming = options.streaming && options.edits.empty();
+	Lexer lex(file_path.c_str(), streaming);
+	TokenTable table; //table of lexemes
+
+	if (streaming) {
+		if (!lex.IsOpen()) {
+			std::cerr << "<E> Can't open file" << std::endl;
+			return -EXIT_FAILURE;
+		}
+		table = TokenTable(lex, Syntax::TOKEN_WINDOW); // lexemes are read while parsing
+	}
+	else
+		table = lex.ScanCode();
+
+	auto syntx = std::make_unique<Syntax>(std::move(table));
+	auto tree = syntx->ParseCode(); // syntax tree
+
+	if (tree != nullptr) {
+		generateCode(tree, *syntx, options);
+	}
+	else
+		std::cerr << "Error: Invalid syntax tree" << std::endl;
+
+	if (!options.edits.empty())
+		return rebuildEdited(std::string(lex.GetSource()), std::move(syntx), options);
+
+	return (tree != nullptr) ? EXIT_SUCCESS : -EXIT_FAILURE;
 }
\ No newline at end of file
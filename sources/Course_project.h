@@ -4,10 +4,12 @@
 #include <fstream>      
 #include <iostream>     
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include "Lexer.h"
 #include "Syntax.h"
+#include "ConstFolder.h"
 #include "GenCode.h"
 
 /*
@@ -24,8 +26,9 @@
  * <for_op>			::= for <id> := <constant> (to | downto) <constant> do <state> | <break_op>
  * <if_op>			::= if <comp> then <state> { ; else <state> } | <break_op>
  * <break_op>		::= break;
- * <assign>			::= <id> := <exp> ;
- * <exp>			::= <id> | <constant> | <comp> | <bool_exp> | <arith_exp>
+ * <assign>			::= ( <id> | <element> ) := <exp> ;
+ * <element>		::= <id> [ <exp> ]
+ * <exp>			::= <id> | <element> | <constant> | <comp> | <bool_exp> | <arith_exp>
  * <comp>			::= <eq> | <noneq> | <big> | <less> | <bigeq> | <leseq>
  * <bool_exp>		::= <or> | <and> | <xor>
  * <eq>				::= <exp> == <exp>
@@ -47,6 +50,14 @@
  * <constant>		::= 0-9
  */
 
-int Compile(const std::string& file_path);
+struct CompileOptions {
+	bool streaming{ false };	// parse while reading lexemes, memory doesn't grow with the file
+	std::vector<TextEdit> edits;	// rebuild after each of them, reusing the last build (no streaming)
+	int opt_level{ 1 };		// -O0 as written, -O1 folding and one peephole sweep, -O2 peephole to fixpoint
+	Target::Kind target{ Target::Kind::x86 };	// -m32 or -m64
+	bool bounds_check{ false };	// --bounds-check, index of array out of range traps at run time
+};
+
+int Compile(const std::string& file_path, const CompileOptions& options = CompileOptions());
 
 #endif //COURSE_PROJECT
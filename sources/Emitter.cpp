@@ -0,0 +1,26 @@
+#include "Emitter.h"
+#include <charconv>
+
+
+Emitter::Emitter(size_t t_reserve) {
+    text.reserve(t_reserve);
+}
+
+
+/**
+ * @brief Append decimal number to the current line
+ * @param[in] t_number - number
+ *
+ * @return the emitter
+ */
+Emitter& Emitter::operator<<(long long t_number) {
+    char digits[24];
+    auto res = std::to_chars(digits, digits + sizeof(digits), t_number);
+    text.append(digits, res.ptr - digits);
+    return *this;
+}
+
+
+void Emitter::Write(std::ostream& t_out) const {
+    t_out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
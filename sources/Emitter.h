@@ -0,0 +1,37 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/*
+ * Output buffer of GAS code. Lines are appended piece by piece in one
+ * contiguous buffer, numbers are formatted in place, so a line costs no
+ * allocation of its own. The buffer keeps its capacity when it's cleared
+ * and the whole code is written by one call.
+ */
+class Emitter
+{
+public:
+	static constexpr size_t INITIAL_BYTES = 1 << 20;
+
+	explicit Emitter(size_t t_reserve = INITIAL_BYTES);
+
+	Emitter&			operator<<(std::string_view t_text) { text.append(t_text); return *this; }
+	Emitter&			operator<<(char t_char) { text.push_back(t_char); return *this; }
+	Emitter&			operator<<(long long t_number);
+	Emitter&			operator<<(int t_number) { return *this << static_cast<long long>(t_number); }
+	void				EndLine() { text.push_back('\n'); }
+
+	size_t				GetBytes() const { return text.size(); }
+
+	void				Clear() { text.clear(); }	// keeps capacity
+	void				Write(std::ostream& t_out) const;
+
+private:
+	std::string		text;		// lines ended by '\n'
+};
+
+#endif // !EMITTER_H
@@ -0,0 +1,57 @@
+#include "FlatTree.h"
+
+/**
+ * @brief Copy syntax tree in post-order, the walk uses its own stack and doesn't
+ *        depend on the depth of the tree
+ * @param[in] t_root - root of syntax tree
+ */
+FlatTree::FlatTree(Tree* t_root) {
+    if (t_root == nullptr)
+        return;
+
+    std::vector<std::pair<Tree*, bool>> walk;   // node, its children are pushed
+    std::vector<index_t> done;                  // copied subtrees which wait for their parent
+    walk.emplace_back(t_root, false);
+
+    while (!walk.empty()) {
+        auto [tree, expanded] = walk.back();
+        if (!expanded) {
+            walk.back().second = true;
+            if (tree->GetRightNode() != nullptr) walk.emplace_back(tree->GetRightNode(), false);
+            if (tree->GetLeftNode() != nullptr)  walk.emplace_back(tree->GetLeftNode(), false);
+            continue;
+        }
+        walk.pop_back();
+
+        Node node{ NO_NODE, tree->GetKind(), tree->GetOperation(), 0 };
+        if (tree->GetRightNode() != nullptr) {
+            node.flags |= HAS_RIGHT;    // it is the last copied node
+            done.pop_back();
+        }
+        if (tree->GetLeftNode() != nullptr) {
+            node.left = done.back();
+            nodes[node.left].flags |= LEFT_CHILD;
+            done.pop_back();
+        }
+
+        done.push_back(static_cast<index_t>(nodes.size()));
+        nodes.push_back(node);
+        symbols.push_back(tree->GetSymbol());
+        numbers.push_back(tree->GetNumber());
+    }
+}
+
+size_t FlatTree::GetBytes() const {
+    return nodes.size() * (sizeof(Node) + sizeof(symbol_t) + sizeof(int));
+}
+
+FlatTree::index_t FlatTree::GetFirst(index_t t_idx) const {
+    for (;;) {
+        if (nodes[t_idx].left != NO_NODE)
+            t_idx = nodes[t_idx].left;
+        else if (nodes[t_idx].flags & HAS_RIGHT)
+            t_idx--;
+        else
+            return t_idx;
+    }
+}
@@ -1,77 +1,89 @@
 #ifndef GENCODE_H
 #define GENCODE_H
 
-#include <algorithm>
 #include <fstream>
-#include <sstream>
 #include <array>
+#include "AsmPrinter.h"
+#include "Emitter.h"
+#include "FlatTree.h"
+#include "MachineCode.h"
+#include "Peephole.h"
+#include "SsaLowering.h"
+#include "SsaOptimizer.h"
+#include "Target.h"
 #include "Syntax.h"
 
 class GenCode {
 public:
-    GenCode(Tree&& t_synt_tree);
+    GenCode(FlatTree&& t_ast, const SymbolTable& t_symbols, int t_level = 1,
+        Target::Kind t_target = Target::Kind::x86, bool t_bounds_check = false);
 
     int GenerateAsm();
+    size_t GetStackOps() const { return stack_ops; }
+    size_t GetBlockCount() const { return block_count; }
+    const Peephole& GetPeephole() const { return peephole; }
+    const SsaOptimizer& GetOptimizer() const { return optimizer; }
+    const SsaLowering& GetLowering() const { return lowering; }
+    size_t GetSsaValues() const { return ssa_values; }
+    size_t GetSsaBlocks() const { return ssa_blocks; }
+    size_t GetSsaPhis() const { return ssa_phis; }
 
     virtual ~GenCode();
 private:
-    Tree* synt_tree;
+    using node_ref = FlatTree::Ref;
+    using Operand = MachineCode::Operand;
+
+    FlatTree ast;
+    const SymbolTable& symbols;
+    node_ref synt_tree;
+    std::unique_ptr<Target> target;
     std::ofstream code;
-    std::ostringstream test_str;
-    size_t num_if{ 0 };
-    size_t num_for{ 0 };
-    std::string breakpoint;
+    MachineCode machine;                  // code of program, printed after peephole pass
+    Emitter out;                          // text of code
+    Peephole peephole;
+    SsaOptimizer optimizer;
+    SsaLowering lowering;                 // keeps names of spill slots for the code
+    bool bounds_check;                    // index of array is checked at run time
+    bool promote;                         // variables are kept in registers, -O0 keeps them in memory
+    size_t stack_ops{ 0 };                // emitted push and pop instructions
+    size_t block_count{ 0 };              // basic blocks of emitted code
+    size_t ssa_values{ 0 };               // values, blocks and phis left by optimizer
+    size_t ssa_blocks{ 0 };
+    size_t ssa_phis{ 0 };
 
     const std::array<std::string, 2> types = { "integer", "boolean" };
     const std::array<std::string, 2> specif = { "array", "const" };
 
     static constexpr const char* DATA_SECT = ".data";
     static constexpr const char* BSS_SECT = ".bss";
-
-    static constexpr const char* TEXT_SECT = ".text";
-    static constexpr const char* GLOB_SECT = ".global _main";
-    static constexpr const char* MAIN_SECT = "_main:";
-    static constexpr const char* RET_SECT = "ret";
-
-    static constexpr const char* EAX_ZERO = "xorl %eax, %eax";
-    static constexpr const char* EBX_ZERO = "xorl %ebx, %ebx";
+    static constexpr const char* SLOT_ALIGN = ".balign 4";
 
     static constexpr const char* BYTE_TYPE = ".byte ";
     static constexpr const char* LONG_TYPE = ".long ";
     static constexpr const char* SPAC_TYPE = ".space ";
 
-    static constexpr const char* LONG_SIZE = "4";
-    static constexpr const char* BYTE_SIZE = "1";
+    static constexpr int LONG_SIZE = 4;
+    static constexpr int BYTE_SIZE = 1;
 
     int generateDeclVars();
-    int generateBssVaar(Tree* node);
-    int generateDataVar(Tree* node);
-    int generateCompound(Tree* node);
-    int GetOperation(const std::string str);
-
-    void generateAfterCondition(Tree* node);
-    void generateThenElseExpr(Tree* node);
+    int generateBssVaar(node_ref node);
+    int generateDataVar(node_ref node);
     void generateTextPart();
-    void generateExpressions(Tree* node);
-    void addLine(std::string&& code_line);
-    void buildLine(std::string&& code_line);
-    void addSpace();
-
-    void generateLabel(const std::string& name, const std::string& type,
-        const std::string& val);
-    void generateEnd();
-    void clearBuffer();
-    void generateConstVars(Tree* var_root);
+    void generateSlots();
+    void writeCode();
 
+    void add(Opcode t_op, Reg t_src, Reg t_dst) {
+        machine.Add(t_op, Operand::MakeReg(t_src), Operand::MakeReg(t_dst));
+    }
 
-    std::string getType(Tree* node);
-    std::string getSpec(Tree* node);
-    std::string getArraySize(Tree* spec_node, std::string type);
-
-    bool checkType(const std::string& type);
-    bool checkSpec(const std::string& spec);
+    void generateLabel(std::string_view name, std::string_view type, const Operand& val);
+    void generateEnd();
 
-    Tree* checkVariable(std::string&& variable);
+    std::string_view getType(node_ref node);
+    std::string_view getSpec(node_ref node);
+    int getArraySize(node_ref spec_node, std::string_view type);
 
+    bool checkType(std::string_view type);
+    bool checkSpec(std::string_view spec);
 };
 #endif //GENCODE_H
@@ -0,0 +1,87 @@
+#include "Interner.h"
+
+Interner::Interner() {
+    slots.assign(1024, NO_SYMBOL);
+}
+
+Interner& Interner::Get() {
+    static Interner interner;
+    return interner;
+}
+
+/**
+ * @brief Get id of spelling, add it in the table if it's new
+ * @param[in] t_str - spelling of lexeme
+ *
+ * @return symbol id
+ */
+symbol_t Interner::Intern(std::string_view t_str) {
+    auto hash = hashOf(t_str);
+    auto mask = slots.size() - 1;
+
+    for (auto i = hash & mask; ; i = (i + 1) & mask) {
+        auto sym = slots[i];
+        if (sym == NO_SYMBOL) {
+            sym = static_cast<symbol_t>(names.size());
+            names.emplace_back(storeText(t_str), t_str.size());
+            hashes.push_back(hash);
+            slots[i] = sym;
+
+            if (names.size() * 2 > slots.size()) // keep load factor under 0.5
+                grow();
+            return sym;
+        }
+        if (hashes[sym] == hash && names[sym] == t_str)
+            return sym;
+    }
+}
+
+symbol_t Interner::Find(std::string_view t_str) const {
+    auto hash = hashOf(t_str);
+    auto mask = slots.size() - 1;
+
+    for (auto i = hash & mask; ; i = (i + 1) & mask) {
+        auto sym = slots[i];
+        if (sym == NO_SYMBOL)
+            return NO_SYMBOL;
+        if (hashes[sym] == hash && names[sym] == t_str)
+            return sym;
+    }
+}
+
+uint32_t Interner::hashOf(std::string_view t_str) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (auto ch : t_str) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const char* Interner::storeText(std::string_view t_str) {
+    if (t_str.size() > chunk_left) {
+        auto size = std::max(CHUNK_SIZE, t_str.size());
+        chunks.emplace_back(new char[size]);
+        chunk_pos = chunks.back().get();
+        chunk_left = size;
+        arena_bytes += size;
+    }
+
+    auto* text = chunk_pos;
+    std::memcpy(text, t_str.data(), t_str.size());
+    chunk_pos += t_str.size();
+    chunk_left -= t_str.size();
+    return text;
+}
+
+void Interner::grow() {
+    slots.assign(slots.size() * 2, NO_SYMBOL);
+    auto mask = slots.size() - 1;
+
+    for (symbol_t sym = 0; sym < names.size(); sym++) {
+        auto i = hashes[sym] & mask;
+        while (slots[i] != NO_SYMBOL)
+            i = (i + 1) & mask;
+        slots[i] = sym;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using symbol_t = uint32_t;
+
+constexpr symbol_t NO_SYMBOL = UINT32_MAX;	// lexeme without own text
+
+/*
+ * Table of unique spellings (identifiers, constants, type names). Every spelling
+ * is stored once in a chunked arena and is referenced by a 32-bit symbol id, so
+ * equal names are equal ids. Text of a symbol never moves and lives until the
+ * end of the program, so views returned by GetName() stay valid.
+ */
+class Interner
+{
+public:
+	static Interner&	Get();		// process-wide table
+
+	symbol_t			Intern(std::string_view t_str);
+	symbol_t			Find(std::string_view t_str) const;		// NO_SYMBOL if unknown
+	std::string_view	GetName(symbol_t t_sym) const { return names[t_sym]; }
+
+	size_t				GetCount() const { return names.size(); }
+	size_t				GetArenaBytes() const { return arena_bytes; }
+
+private:
+	Interner();
+
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>>	chunks;		// arena with text of symbols
+	char*									chunk_pos{ nullptr };
+	size_t									chunk_left{ 0 };
+	size_t									arena_bytes{ 0 };
+
+	std::vector<std::string_view>			names;		// symbol id -> text
+	std::vector<uint32_t>					hashes;		// symbol id -> hash of text
+	std::vector<symbol_t>					slots;		// open addressing table of ids
+
+	static uint32_t		hashOf(std::string_view t_str);
+	const char*			storeText(std::string_view t_str);
+	void				grow();
+};
+
+#endif // !INTERNER_H
@@ -0,0 +1,101 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <array>
+#include <cstring>
+#include "Lexem.h"
+
+/*
+ * Keyword recognition by a perfect hash. The hash is built from the length,
+ * the first and the last character of a word; the table is filled at compile
+ * time and the build breaks if two keywords ever fall into one slot.
+ */
+
+struct Keyword {
+    const char*     name;
+    size_t          len;
+    tokens          token;
+};
+
+constexpr Keyword keywords[] = {
+    { "program", 7, program_tk    },
+    { "var",     3, var_tk        },
+    { "begin",   5, begin_tk      },
+    { "integer", 7, type_tk       },
+    { "boolean", 7, type_tk       },
+    { "array",   5, arr_tk        },
+    { "of",      2, of_tk         },
+    { "end",     3, end_tk        },
+    { "div",     3, div_tk        },
+    { "and",     3, and_tk        },
+    { "or",      2, or_tk         },
+    { "xor",     3, xor_tk        },
+    { "if",      2, if_tk         },
+    { "for",     3, for_tk        },
+    { "to",      2, to_tk         },
+    { "downto",  6, downto_tk     },
+    { "do",      2, do_tk         },
+    { "false",   5, bool_false_tk },
+    { "true",    4, bool_true_tk  },
+    { "break",   5, break_tk      },
+    { "then",    4, then_tk       },
+    { "else",    4, else_tk       },
+};
+
+constexpr size_t KEYWORD_COUNT   = sizeof(keywords) / sizeof(keywords[0]);
+constexpr size_t KEYWORD_MIN_LEN = 2;
+constexpr size_t KEYWORD_MAX_LEN = 7;
+constexpr size_t KEYWORD_SLOTS   = 64;
+
+constexpr size_t KeywordHash(size_t len, char first, char last) {
+    return (len + 2 * static_cast<unsigned char>(first) +
+            4 * static_cast<unsigned char>(last)) & (KEYWORD_SLOTS - 1);
+}
+
+struct KeywordTable {
+    std::array<signed char, KEYWORD_SLOTS>  slot{};     // index in keywords[] or -1
+    bool                                    perfect{ true };
+};
+
+constexpr KeywordTable buildKeywordTable() {
+    KeywordTable table;
+    for (size_t i = 0; i < KEYWORD_SLOTS; i++)
+        table.slot[i] = -1;
+
+    for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+        const auto& kw = keywords[i];
+        auto h = KeywordHash(kw.len, kw.name[0], kw.name[kw.len - 1]);
+        if (table.slot[h] != -1)
+            table.perfect = false;
+        table.slot[h] = static_cast<signed char>(i);
+    }
+
+    return table;
+}
+
+constexpr KeywordTable keyword_table = buildKeywordTable();
+static_assert(keyword_table.perfect, "Keyword hash has collisions, change KeywordHash()");
+
+/**
+ * @brief Classify identifier as keyword
+ * @param[in] str - first character of word
+ * @param[in] len - length of word
+ *
+ * @return token of keyword or id_tk if word isn't a keyword
+ */
+inline tokens FindKeyword(const char* str, size_t len) {
+    if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN)
+        return id_tk;
+
+    auto idx = keyword_table.slot[KeywordHash(len, str[0], str[len - 1])];
+    if (idx < 0)
+        return id_tk;
+
+    const auto& kw = keywords[idx];
+    if (kw.len != len || std::memcmp(kw.name, str, len) != 0)
+        return id_tk;
+
+    return kw.token;
+}
+
+#endif // !KEYWORDS_H
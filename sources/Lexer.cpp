@@ -1,8 +1,43 @@
 #include "Lexer.h"
+#include <algorithm>
+#include <cstring>
+#include "Keywords.h"
+#include "CharScanner.h"
 
-Lexer::Lexer(const char* file_path) {
+Lexer::Lexer(const char* file_path, bool t_streaming) {
     try {
-        code.open(file_path);
+        size_t size = 0;
+        std::ifstream code(file_path, std::ios::in | std::ios::binary);
+        if (code.is_open() && t_streaming) {
+            // only a chunk of the file is kept, NextLex reads the next one
+            // when the scanner gets to the end of this one
+            stream = std::move(code);
+            stream_done = false;
+            is_open = true;
+            source.assign(1 + CharScanner::SCAN_PADDING, '\0');
+            cursor = source_end = source.data();
+            refill(cursor);
+            return;
+        }
+
+        if (code.is_open()) {
+            code.seekg(0, std::ios::end);
+            size = static_cast<size_t>(code.tellg());
+            code.seekg(0, std::ios::beg);
+
+            // read the whole file at once, it's followed by the '\0' sentinel
+            // and zero padding for the block reads of CharScanner
+            source.resize(size + 1 + CharScanner::SCAN_PADDING);
+            code.read(source.data(), size);
+            size = static_cast<size_t>(code.gcount());
+            is_open = true;
+        }
+        else {
+            source.assign(1 + CharScanner::SCAN_PADDING, '\0');
+        }
+
+        cursor = source.data();
+        source_end = source.data() + size;
     }
     catch (const std::exception& exp) {
         std::string lel(exp.what());
@@ -11,17 +46,31 @@ Lexer::Lexer(const char* file_path) {
     }
 }
 
-std::vector<Lexem> Lexer::ScanCode()
+Lexer::Lexer(const char* t_text, size_t t_size) {
+    source.resize(t_size + 1 + CharScanner::SCAN_PADDING);
+    std::copy(t_text, t_text + t_size, source.data());
+    is_open = true;
+
+    cursor = source.data();
+    source_end = source.data() + t_size;
+}
+
+TokenTable Lexer::ScanCode()
 {
     try {
-        if (!code.is_open()) {
+        if (!is_open) {
             std::cerr << "<E> Can't open file" << std::endl;
             return lex_table;
         }
 
-        while (!code.eof()) {
-            lex_table.emplace_back(GetLex());
-        }
+        lex_table.Reserve(source.size() / 4); // rough guess, avoids most of reallocations
+
+        Lexem lex;
+        uint32_t offset = 0;
+        do {
+            lex = NextLex(offset);
+            lex_table.Add(lex, offset);
+        } while (lex.GetToken() != eof_tk);
 
         return lex_table;
     }
@@ -31,69 +80,172 @@ std::vector<Lexem> Lexer::ScanCode()
     }
 }
 
-Lexer::~Lexer() {
-    code.close();
+// lexer can restart after these and the old lexemes can be taken back from them
+static bool isBoundary(tokens t_tok) {
+    return t_tok == semi_tk || t_tok == begin_tk || t_tok == end_tk || t_tok == eof_tk;
 }
 
-Lexem Lexer::GetLex()
+/**
+ * @brief Get table of lexemes of the edited source from the table of the old one
+ * @param[in]  t_old    - lexemes of the source before the edit
+ * @param[in]  t_edit   - edit applied to the old source (this lexer has the new one)
+ * @param[out] t_damage - range of the lexemes changed by the edit
+ *
+ * @return table of lexemes of the new source
+ *
+ * Lexing restarts after the last statement boundary (';', 'begin', 'end') in
+ * front of the edit. It stops as soon as it meets a boundary lexeme behind the
+ * edit that the old table has at the same place, the rest is copied from the
+ * old table with moved offsets and lines.
+ */
+TokenTable Lexer::Rescan(const TokenTable& t_old, const TextEdit& t_edit, TokenDamage& t_damage)
 {
     try {
-        auto ch = GetCurrentCurs();
-        while (ch == -1 || ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t') {
-            if (ch == '\n') line++;
+        TokenTable table;
+        auto old_count = t_old.size();
+        auto edit_end = static_cast<int64_t>(t_edit.offset) + t_edit.text.size(); // in the new source
+        auto delta = static_cast<int64_t>(t_edit.text.size()) - t_edit.removed;
 
-            ch = GetChar();
+        // a lexeme right before the edit may grow into it, so step back to a boundary
+        size_t first = t_old.FindOffset(t_edit.offset);
+        while (first > 0) {
+            auto prev = first - 1;
+            auto prev_end = t_old.GetOffset(prev) + t_old.GetName(prev).size();
+            if (isBoundary(t_old.GetToken(prev)) && prev_end < t_edit.offset)
+                break;
+            first = prev;
+        }
 
+        table.Reserve(old_count + t_edit.text.size() / 4);
+        for (size_t i = 0; i < first; i++)
+            table.Add(t_old.GetLexem(i), t_old.GetOffset(i));
 
-            if (code.eof()) return Lexem(std::move("EOF"), eof_tk, line); // if end of file
+        line = 0;
+        cursor = source.data();
+        if (first > 0) {
+            cursor += t_old.GetOffset(first - 1) + t_old.GetName(first - 1).size();
+            line = t_old.GetLine(first - 1);
         }
 
-        auto isId = [](char ch) {
-            return std::isalpha(static_cast<unsigned char>(ch)) ||
-                std::isdigit(static_cast<unsigned char>(ch));
-        };
+        auto old_idx = t_old.FindOffset(t_edit.offset + t_edit.removed);
+        auto old_end = old_count;
+        auto line_shift = 0;
+        for (;;) {
+            auto lex = GetLex();
 
+            if (lex_offset >= edit_end && isBoundary(lex.GetToken())) {
+                auto old_offset = lex_offset - delta; // the same text in the old source
+                while (old_idx < old_count && t_old.GetOffset(old_idx) < old_offset)
+                    old_idx++;
 
-        std::string lex;
-        if (std::isdigit(static_cast<unsigned char>(ch))) { // Constants (Numbers)
-            while (std::isdigit(static_cast<unsigned char>(ch))) {
-                lex += ch;
-                ch = GetChar();
+                if (old_idx < old_count && t_old.GetOffset(old_idx) == old_offset
+                    && t_old.GetToken(old_idx) == lex.GetToken()
+                    && t_old.GetSymbol(old_idx) == lex.GetSymbol()) {
+                    old_end = old_idx;
+                    line_shift = lex.GetLine() - t_old.GetLine(old_idx);
+                    break;
+                }
             }
 
-            return Lexem(std::move(lex), constant_tk, line);
+            table.Add(lex, lex_offset);
+            if (lex.GetToken() == eof_tk)
+                break;
+        }
+
+        t_damage.first = t_old.GetOffset(first);
+        t_damage.old_end = t_damage.new_end = UINT32_MAX;
+        if (old_end < old_count) {
+            t_damage.old_end = t_old.GetOffset(old_end);
+            t_damage.new_end = static_cast<uint32_t>(t_damage.old_end + delta);
+        }
+
+        for (auto i = old_end; i < old_count; i++) {
+            Lexem lex(t_old.GetToken(i), t_old.GetSymbol(i), t_old.GetLine(i) + line_shift);
+            table.Add(lex, static_cast<uint32_t>(t_old.GetOffset(i) + delta));
+        }
+        t_damage.reused = first + (old_count - old_end);
+
+        return table;
+    }
+    catch (const std::exception& exp) {
+        std::cerr << "<E> Catch exception in " << __func__ << ": " << exp.what() << std::endl;
+        return TokenTable();
+    }
+}
+
+// the EOF lexeme is repeated at the end of file
+Lexem Lexer::NextLex(uint32_t& t_offset) {
+    for (;;) {
+        auto start = cursor;
+        auto start_line = line;
+        auto lex = GetLex();
+
+        // a lexeme that ends on the chunk end may go on in the next chunk,
+        // scan it again from the start after the refill
+        if (cursor != source_end || stream_done) {
+            t_offset = lex_offset;
+            return lex;
+        }
+
+        if (lex.GetToken() == eof_tk) { // only spaces were left
+            start = cursor;
+            start_line = line;
+        }
+        refill(start);
+        line = start_line;
+    }
+}
+
+/**
+ * @brief Read the next chunk of the file in the streaming mode
+ * @param[in] t_keep - the source from here to the sentinel is moved in front of the chunk
+ *
+ * @note The buffer grows only for a lexeme longer than the chunk.
+ */
+void Lexer::refill(const char* t_keep)
+{
+    auto kept = static_cast<size_t>(source_end - t_keep);
+    stream_base += static_cast<uint32_t>(t_keep - source.data());
+    std::memmove(source.data(), t_keep, kept);
+
+    auto need = kept + STREAM_CHUNK + 1 + CharScanner::SCAN_PADDING;
+    if (source.size() < need)
+        source.resize(need);
+
+    stream.read(source.data() + kept, STREAM_CHUNK);
+    auto size = kept + static_cast<size_t>(stream.gcount());
+    stream_done = !stream;
+    std::fill(source.data() + size, source.data() + size + 1 + CharScanner::SCAN_PADDING, '\0');
+
+    cursor = source.data();
+    source_end = source.data() + size;
+}
+
+Lexer::~Lexer() = default;
+
+Lexem Lexer::GetLex()
+{
+    try {
+        cursor = CharScanner::SkipSpaces(cursor, line);
+        lex_offset = stream_base + static_cast<uint32_t>(cursor - source.data());
+
+        if (IsEof()) return Lexem(eof_tk, line); // if end of file
+
+        auto ch = GetCurrentCurs();
+        const char* start = cursor; // first character of lexeme
+        if (std::isdigit(static_cast<unsigned char>(ch))) { // Constants (Numbers)
+            cursor = CharScanner::SkipDigits(cursor);
+
+            return Lexem(constant_tk, InternLex(start), line);
         }
         else if (std::isalpha(static_cast<unsigned char>(ch))) { // Identificators
-            while (isId(ch)) {
-                lex += ch;
-                ch = GetChar();
-            }
+            cursor = CharScanner::SkipIdent(cursor);
 
-            if (lex == "program")       { return Lexem(std::move(lex), program_tk, line); }
-            else if (lex == "var")      { return Lexem(std::move(lex), var_tk, line); }
-            else if (lex == "begin")    { return Lexem(std::move(lex), begin_tk, line); }
-            else if (lex == "integer")  { return Lexem(std::move(lex), type_tk, line); }
-            else if (lex == "boolean")  { return Lexem(std::move(lex), type_tk, line); }
-            else if (lex == "array")    { return Lexem(std::move(lex), arr_tk, line); }
-            else if (lex == "of")       { return Lexem(std::move(lex), of_tk, line); }
-            else if (lex == "end")      { return Lexem(std::move(lex), end_tk, line); }
-            else if (lex == "div")      { return Lexem(std::move(lex), div_tk, line); }
-            else if (lex == "and")      { return Lexem(std::move(lex), and_tk, line); }
-            else if (lex == "or")       { return Lexem(std::move(lex), or_tk, line); }
-            else if (lex == "xor")      { return Lexem(std::move(lex), xor_tk, line); }
-            else if (lex == "if")       { return Lexem(std::move(lex), if_tk, line); }
-            else if (lex == "for")      { return Lexem(std::move(lex), for_tk, line); }
-            else if (lex == "to")       { return Lexem(std::move(lex), to_tk, line); }
-            else if (lex == "downto")   { return Lexem(std::move(lex), downto_tk, line); }
-            else if (lex == "do")       { return Lexem(std::move(lex), do_tk, line); }
-            else if (lex == "false")    { return Lexem(std::move(lex), bool_false_tk, line); }
-            else if (lex == "true")     { return Lexem(std::move(lex), bool_true_tk, line); }
-            else if (lex == "break")    { return Lexem(std::move(lex), break_tk, line); }
-            else if (lex == "then")     { return Lexem(std::move(lex), then_tk, line); }
-            else if (lex == "else")     { return Lexem(std::move(lex), else_tk, line); }
-            else { // it is ID
-                return Lexem(std::move(lex), id_tk, line);
-            }
+            auto tok = FindKeyword(start, static_cast<size_t>(cursor - start));
+            if (tok == id_tk || tok == type_tk) // these have own spelling
+                return Lexem(tok, InternLex(start), line);
+
+            return Lexem(tok, line);
         }
         else if (std::ispunct(static_cast<unsigned char>(ch))) { // Other symbols
             tokens tok{ unknown_tk };
@@ -117,90 +269,43 @@ Lexem Lexer::GetLex()
                 tok = unknown_tk;
                 break;
             }
-            lex += ch;
-
-            // ':='
-            if (tok == ddt_tk) {
-                ch = GetChar();
-                if (ch == '=') {
-                    lex += ch;
-                    tok = ass_tk;
-                }
-            }
 
-            // '..'
-            if (tok == dot_tk) {
-                ch = GetChar();
-                if (ch == '.') {
-                    lex += ch;
-                    tok = dots_arr_tk;
-                }
+            // two-character operators: look at the next byte before consuming it
+            auto next = PeekChar();
+            auto pair_tok = tok;
+            switch (tok) {
+            case ddt_tk:         if (next == '=') pair_tok = ass_tk;            break; // ':='
+            case dot_tk:         if (next == '.') pair_tok = dots_arr_tk;       break; // '..'
+            case eqv_tk:         if (next == '=') pair_tok = bool_eqv_tk;       break; // '=='
+            case bool_bigger_tk: if (next == '=') pair_tok = bool_bigeqv_tk;    break; // '>='
+            case bool_less_tk: {
+                if (next == '=')      pair_tok = bool_leseqv_tk;                       // '<='
+                else if (next == '>') pair_tok = bool_noneqv_tk;                       // '<>'
+                break;
             }
-
-            // '=='
-            if (tok == eqv_tk) {
-                ch = GetChar();
-                if (ch == '=') {
-                    lex += ch;
-                    tok = bool_eqv_tk;
-                }
+            default:
+                break;
             }
 
-            // '>='
-            if (tok == bool_bigger_tk) {
-                ch = GetChar();
-                if (ch == '=') {
-                    lex += ch;
-                    tok = bool_bigeqv_tk;
-                }
+            if (pair_tok != tok) {
+                tok = pair_tok;
+                GetChar();
             }
 
-            // '<='
-            if (tok == bool_less_tk) {
-                ch = GetChar();
-                if (ch == '=') {
-                    lex += ch;
-                    tok = bool_leseqv_tk;
-                }
-            }
+            GetChar();
+            if (tok == unknown_tk)
+                return Lexem(tok, InternLex(start), line);
 
-            // '<>'
-            if (tok == bool_less_tk) {
-                ch = GetChar();
-                if (ch == '>') {
-                    lex += ch;
-                    tok = bool_noneqv_tk;
-                }
-            }
-
-            GetChar(); // some kind of k o s t y l; here we look on \n
-            return Lexem(std::move(lex), tok, line);
+            return Lexem(tok, line);
         }
         else {
             std::cerr << "<E> Unknown token " << ch << std::endl;
+            GetChar();
         }
 
-        return Lexem(std::move(""), unknown_tk, line);
+        return Lexem(unknown_tk, line);
     }
     catch (const std::exception&) {
-        return Lexem(std::move(""), unknown_tk, line);
-    }
-}
-
-char Lexer::GetChar()
-{
-    if (code.fail()) {
-        std::cerr << "<E> Can't read from the file" << std::endl;
-        throw std::runtime_error("File doesn't available");
+        return Lexem(unknown_tk, line);
     }
-
-    if (!code.eof()) {
-        code >> std::noskipws >> cursor;
-    }
-    else {
-        std::cerr << "<E> File is EOF early" << std::endl;
-        throw std::runtime_error("File is EOF early");
-    }
-
-    return cursor;
 }
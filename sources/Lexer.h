@@ -1,31 +1,61 @@
-#ifndef LEXER_H
-#define LEXER_H
-
-#include <fstream>
-#include <iostream>
-#include <vector>
-#include "Lexem.h"
-
-class Lexer
-{
-public:
-
-	explicit Lexer(const char* file_path);
-	std::vector<Lexem>	ScanCode();
-	~Lexer();
-
-private:
-	std::ifstream		code;
-	char				cursor{ -1 };
-	int					line{ 0 };
-	std::vector<Lexem>	lex_table;
-
-	Lexem				GetLex();
-	char				GetChar();
-
-	inline char			GetCurrentCurs() { return cursor; }
-
-};
-
-#endif // !LEXER_H
-
+#ifndef LEXER_H
+#define LEXER_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TokenTable.h"
+
+// replace 'removed' bytes at 'offset' of the source with 'text'
+struct TextEdit {
+	uint32_t	offset{ 0 };
+	uint32_t	removed{ 0 };
+	std::string	text;
+};
+
+class Lexer
+{
+public:
+
+	static constexpr size_t STREAM_CHUNK = 64 * 1024;	// bytes read at once in the streaming mode
+
+	explicit Lexer(const char* file_path, bool t_streaming = false);
+	Lexer(const char* t_text, size_t t_size);	// source from memory
+	TokenTable			ScanCode();
+	TokenTable			Rescan(const TokenTable& t_old, const TextEdit& t_edit, TokenDamage& t_damage);
+	// whole source, only the current chunk in the streaming mode
+	std::string_view	GetSource() const { return std::string_view(source.data(), static_cast<size_t>(source_end - source.data())); }
+	Lexem				NextLex(uint32_t& t_offset);	// for the streaming mode
+	bool				IsOpen() { return is_open; }
+	~Lexer();
+
+private:
+	std::vector<char>	source;					// whole file or its chunk, '\0' sentinel and padding
+	const char*			cursor{ nullptr };		// current character of the source
+	const char*			source_end{ nullptr };	// position of the sentinel
+	std::ifstream		stream;					// file of the streaming mode
+	uint32_t			stream_base{ 0 };		// offset of the chunk in the file
+	bool				stream_done{ true };	// the last chunk is in the source
+	bool				is_open{ false };
+	int					line{ 0 };
+	uint32_t			lex_offset{ 0 };		// offset of the last scanned lexeme
+	TokenTable			lex_table;
+
+	Lexem				GetLex();
+	void				refill(const char* t_keep);
+
+	// scanning stops on the '\0' sentinel, so GetChar never steps over it
+	inline char			GetChar() { return *++cursor; }
+	inline char			GetCurrentCurs() { return *cursor; }
+	inline char			PeekChar() { return (cursor != source_end) ? cursor[1] : '\0'; }
+	inline bool			IsEof() { return cursor == source_end; }
+
+	// symbol of text from t_start to the cursor
+	inline symbol_t		InternLex(const char* t_start) {
+		return Interner::Get().Intern(std::string_view(t_start, static_cast<size_t>(cursor - t_start)));
+	}
+
+};
+
+#endif // !LEXER_H
@@ -0,0 +1,81 @@
+#include "MachineCode.h"
+
+
+bool MachineCode::Operand::operator==(const Operand& t_other) const {
+    if (kind != t_other.kind)
+        return false;
+
+    switch (kind) {
+    case none:
+        return true;
+    case reg:
+        return r == t_other.r;
+    case address:
+        return r == t_other.r && index == t_other.index && value == t_other.value;
+    case label:
+        return label_kind == t_other.label_kind && value == t_other.value && name == t_other.name;
+    default:
+        return value == t_other.value && name == t_other.name && index == t_other.index;
+    }
+}
+
+
+MachineCode::MachineCode()
+    : names(1) {}
+
+
+/**
+ * @brief Add name to the table of code
+ * @param[in] t_name - name which lives longer than the code
+ *
+ * @return index of name
+ * @note Operands are equal if they have the same index, so a name which is
+ * used again is taken by the index kept by caller
+ */
+MachineCode::name_t MachineCode::AddName(std::string_view t_name) {
+    if (t_name.empty())
+        return 0;
+
+    names.push_back(t_name);
+    return static_cast<name_t>(names.size() - 1);
+}
+
+
+void MachineCode::Clear() {
+    code.clear();
+    blocks.clear();
+    names.resize(1);
+}
+
+
+/**
+ * @brief Find basic blocks of the code: a block starts at a label and after a
+ *        jump or return
+ * @param none
+ *
+ * @return blocks in order of the code, directives are in blocks too
+ */
+const std::vector<MachineCode::Block>& MachineCode::SplitBlocks() {
+    blocks.clear();
+
+    uint32_t first = 0;
+    auto open = false;  // block has a label or instruction
+    for (uint32_t i = 0; i < code.size(); i++) {
+        auto op = code[i].op;
+        if (op == Opcode::label && open) {
+            blocks.push_back({ first, i });
+            first = i;
+        }
+        if (IsInstruction(op) || op == Opcode::label)
+            open = true;
+        if (IsJump(op) || op == Opcode::ret) {
+            blocks.push_back({ first, i + 1 });
+            first = i + 1;
+            open = false;
+        }
+    }
+    if (first != code.size())
+        blocks.push_back({ first, static_cast<uint32_t>(code.size()) });
+
+    return blocks;
+}
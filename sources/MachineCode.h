@@ -0,0 +1,157 @@
+#ifndef MACHINECODE_H
+#define MACHINECODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// registers by number, temporaries of expressions are taken in this order,
+// the target has the first Target::GetRegCount() of them
+enum Reg : uint8_t {
+	eax, ebx, esi, edi, edx, ecx,
+	r8d, r9d, r10d, r11d, r12d, r13d, r14d, r15d,
+	esp, ebp,		// stack, not allocated
+	REG_COUNT
+};
+
+enum class Opcode : uint8_t {
+	mov, add, sub, imul, and_, or_, xor_, cmp, idiv, cltd, shl, sar, shr, neg, lea, xchg, push, pop,
+	movzb, movb,	// byte of src to a register, %al or immediate to a byte of memory
+	sete, setne, setl, setle, setg, setge,				// %al by flags, in order of jumps
+	cmove, cmovne, cmovl, cmovle, cmovg, cmovge,		// register or memory to a register
+	jmp, je, jne, jl, jle, jg, jge,
+	ja,				// unsigned, for the check of index
+	leave, ret,
+	ud2,			// trap of index out of range
+	label,			// definition of label in src
+	data,			// variable: name in src, value in dst, directive in text
+	directive,		// line of text, empty line too
+	separator,		// empty line between statements
+};
+
+enum class LabelKind : uint8_t {
+	name,			// name with number of repeat if it isn't 0
+	block,			// _bbN_, block of code without a label of statement
+	nope,			// _nopeN_, 'then' is skipped
+	end,			// _endN_, end of if
+	loop,			// _forN_
+	loop_done,		// _forN_done_
+};
+
+/*
+ * Instructions of program between GenCode and the text of GAS. Operands keep
+ * registers by number and names by index in the table of code, so the code is
+ * read and rewritten by passes without parsing, AsmPrinter makes the text of
+ * target. An instruction takes 32 bytes. Basic blocks start at labels and
+ * after jumps.
+ */
+class MachineCode
+{
+public:
+	using name_t = uint32_t;		// index of name, 0 is no name
+
+	struct Operand {
+		enum Kind : uint8_t {
+			none,
+			reg,
+			imm,			// value, or name of undeclared variable
+			mem,			// name + value bytes(, index register, scale), index is 32-bit only
+			address,		// value(base register, index register, scale)
+			label,			// kind, number in value, name
+		};
+
+		// no member initializers: Operand{} is none and the operand is usable
+		// in default arguments of MachineCode
+		static constexpr uint8_t NO_INDEX = UINT8_MAX;
+
+		Kind		kind;
+		Reg			r;
+		LabelKind	label_kind;
+		uint8_t		index;		// index register << 2 | log2 of scale, it fits in padding
+		int			value;
+		name_t		name;
+
+		static Operand	MakeReg(Reg t_r) { return { reg, t_r, LabelKind::name, NO_INDEX, 0, 0 }; }
+		static Operand	MakeImm(int t_value) { return { imm, eax, LabelKind::name, NO_INDEX, t_value, 0 }; }
+		static Operand	MakeName(name_t t_name) { return { imm, eax, LabelKind::name, NO_INDEX, 0, t_name }; }
+		static Operand	MakeMem(name_t t_name, int t_offset = 0) {
+			return { mem, eax, LabelKind::name, NO_INDEX, t_offset, t_name };
+		}
+		static Operand	MakeIndexed(name_t t_name, int t_offset, Reg t_index, int t_scale) {
+			auto operand = MakeMem(t_name, t_offset);
+			operand.index = MakeScaled(eax, t_index, t_scale).index;
+			return operand;
+		}
+		static Operand	MakeAddress(Reg t_base, int t_disp) {
+			return { address, t_base, LabelKind::name, NO_INDEX, t_disp, 0 };
+		}
+		static Operand	MakeScaled(Reg t_base, Reg t_index, int t_scale, int t_disp = 0) {
+			auto shift = (t_scale == 8) ? 3 : (t_scale == 4) ? 2 : (t_scale == 2) ? 1 : 0;
+			return { address, t_base, LabelKind::name, static_cast<uint8_t>(t_index << 2 | shift), t_disp, 0 };
+		}
+		static Operand	MakeLabel(LabelKind t_kind, size_t t_num, name_t t_name = 0) {
+			return { label, eax, t_kind, NO_INDEX, static_cast<int>(t_num), t_name };
+		}
+
+		bool	IsReg(Reg t_r) const { return kind == reg && r == t_r; }
+		bool	IsImm(int t_value) const { return kind == imm && name == 0 && value == t_value; }
+		bool	HasIndex() const { return (kind == address || kind == mem) && index != NO_INDEX; }
+		Reg		GetIndex() const { return static_cast<Reg>(index >> 2); }
+		int		GetScale() const { return 1 << (index & 3); }
+		bool	DependsOn(Reg t_r) const {
+			return ((kind == reg || kind == address) && r == t_r) || (HasIndex() && GetIndex() == t_r);
+		}
+		bool	operator==(const Operand& t_other) const;
+		bool	operator!=(const Operand& t_other) const { return !(*this == t_other); }
+	};
+
+	struct Instr {
+		Opcode		op;
+		bool		wide;		// 64-bit operation
+		Operand		src;		// the only operand of one-operand instruction
+		Operand		dst;
+		name_t		text;		// directive
+	};
+
+	// instructions [first, last)
+	struct Block {
+		uint32_t	first;
+		uint32_t	last;
+	};
+
+	MachineCode();
+
+	void	Add(Opcode t_op, const Operand& t_src = {}, const Operand& t_dst = {}, bool t_wide = false) {
+		code.push_back({ t_op, t_wide, t_src, t_dst, 0 });
+	}
+	void	AddLabel(const Operand& t_label) { code.push_back({ Opcode::label, false, t_label, {}, 0 }); }
+	void	AddDirective(std::string_view t_text) { code.push_back({ Opcode::directive, false, {}, {}, AddName(t_text) }); }
+	void	AddSeparator() { code.push_back({ Opcode::separator, false, {}, {}, 0 }); }
+	void	AddData(std::string_view t_name, std::string_view t_directive, const Operand& t_value) {
+		code.push_back({ Opcode::data, false, Operand::MakeMem(AddName(t_name)), t_value, AddName(t_directive) });
+	}
+
+	name_t				AddName(std::string_view t_name);
+	std::string_view	GetName(name_t t_name) const { return names[t_name]; }
+
+	void			Reserve(size_t t_count) { code.reserve(t_count); }
+	size_t			size() const { return code.size(); }
+	Instr&			operator[](size_t t_idx) { return code[t_idx]; }
+	const Instr&	operator[](size_t t_idx) const { return code[t_idx]; }
+	std::vector<Instr>&	GetCode() { return code; }
+	void			Clear();
+
+	const std::vector<Block>&	SplitBlocks();
+
+	static bool		IsJump(Opcode t_op) { return t_op >= Opcode::jmp && t_op <= Opcode::ja; }
+	static bool		IsByteSource(Opcode t_op) { return t_op >= Opcode::movzb && t_op <= Opcode::setge; }
+	static bool		IsInstruction(Opcode t_op) { return t_op < Opcode::label; }
+
+private:
+	std::vector<Instr>		code;
+	std::vector<Block>		blocks;
+	std::vector<std::string_view>	names;		// views of names of tree and symbols
+};
+
+#endif // !MACHINECODE_H
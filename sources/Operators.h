@@ -0,0 +1,87 @@
+#ifndef OPERATORS_H
+#define OPERATORS_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "Lexem.h"
+
+/*
+ * Binary operators of expressions. The table of priorities is indexed by token
+ * and filled at compile time, so the parser finds an operator in one load.
+ * A bigger priority binds tighter, all operators are left associative.
+ */
+
+enum class OpKind : uint8_t {
+    none,
+    eq, ne, gt, lt, ge, le,     // comparisons
+    add, sub, mul, div,
+    and_, or_, xor_,
+};
+
+struct Operator {
+    tokens              token;
+    int                 priority;
+    OpKind              kind;
+    std::string_view    name;       // value of the node in the syntax tree
+};
+
+constexpr Operator operators[] = {
+    { eqv_tk,         1, OpKind::eq,   "="   },
+    { bool_eqv_tk,    1, OpKind::eq,   "="   },   // '==' is the same comparison
+    { bool_noneqv_tk, 1, OpKind::ne,   "<>"  },
+    { bool_bigger_tk, 1, OpKind::gt,   ">"   },
+    { bool_less_tk,   1, OpKind::lt,   "<"   },
+    { bool_bigeqv_tk, 1, OpKind::ge,   ">="  },
+    { bool_leseqv_tk, 1, OpKind::le,   "<="  },
+    { plus_tk,        2, OpKind::add,  "+"   },
+    { minus_tk,       2, OpKind::sub,  "-"   },
+    { or_tk,          2, OpKind::or_,  "or"  },
+    { xor_tk,         2, OpKind::xor_, "xor" },
+    { mul_tk,         3, OpKind::mul,  "*"   },
+    { div_tk,         3, OpKind::div,  "div" },
+    { and_tk,         3, OpKind::and_, "and" },
+};
+
+constexpr size_t OPERATOR_COUNT = sizeof(operators) / sizeof(operators[0]);
+constexpr size_t TOKEN_SLOTS    = eof_tk - unknown_tk + 1;
+
+struct OperatorTable {
+    std::array<signed char, TOKEN_SLOTS>    slot{};     // index in operators[] or -1
+    bool                                    unique{ true };
+};
+
+constexpr OperatorTable buildOperatorTable() {
+    OperatorTable table;
+    for (size_t i = 0; i < TOKEN_SLOTS; i++)
+        table.slot[i] = -1;
+
+    for (size_t i = 0; i < OPERATOR_COUNT; i++) {
+        auto idx = operators[i].token - unknown_tk;
+        if (table.slot[idx] != -1)
+            table.unique = false;
+        table.slot[idx] = static_cast<signed char>(i);
+    }
+
+    return table;
+}
+
+constexpr OperatorTable operator_table = buildOperatorTable();
+static_assert(operator_table.unique, "Token is listed twice in operators[]");
+
+/**
+ * @brief Get binary operator of token
+ * @param[in] token_tk - token of lexeme
+ *
+ * @return operator or nullptr if token isn't a binary operator
+ */
+inline const Operator* FindOperator(tokens token_tk) {
+    auto idx = operator_table.slot[token_tk - unknown_tk];
+    return (idx < 0) ? nullptr : &operators[idx];
+}
+
+inline bool IsComparison(OpKind op) {
+    return op >= OpKind::eq && op <= OpKind::le;
+}
+
+#endif // !OPERATORS_H
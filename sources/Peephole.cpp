@@ -0,0 +1,314 @@
+#include "Peephole.h"
+
+const std::array<Peephole::Rule, Peephole::RULE_COUNT> Peephole::RULES = { {
+    { "separator",    1, &Peephole::dropSeparator },   // " "
+    { "push_pop",     2, &Peephole::foldPushPop },     // pushl X; popl Y -> movl X, Y
+    { "self_move",    1, &Peephole::dropSelfMove },    // movl R, R
+    { "zero_xor",     1, &Peephole::zeroByXor },       // movl $0, R -> xorl R, R
+    { "store_load",   2, &Peephole::forwardStore },    // movl R, M; movl M, S -> movl R, S
+    { "reload",       2, &Peephole::dropReload },      // movl M, R; movl M, R
+    { "neutral_op",   1, &Peephole::dropNeutralOp },   // addl $0, R; imull $1, R
+    { "jump_to_next", 2, &Peephole::dropJumpToNext },  // jmp L; L:
+} };
+
+
+Peephole::Peephole(int t_level)
+    : level(t_level) {}
+
+
+/**
+ * @brief Apply rules of the table to the code
+ * @param[in,out] t_code - instructions of program
+ *
+ * @return number of removed instructions
+ */
+size_t Peephole::Run(MachineCode& t_code) {
+    if (level <= 0)
+        return 0;
+
+    code = &t_code.GetCode();
+    dead.assign(code->size(), false);
+
+    auto before = removed;
+    while (sweep() && level > 1) {}
+
+    size_t kept = 0;
+    for (size_t i = 0; i < code->size(); i++) {
+        if (!dead[i])
+            (*code)[kept++] = (*code)[i];
+    }
+    code->resize(kept);
+    code = nullptr;
+
+    return removed - before;
+}
+
+
+/**
+ * @brief Try every rule at every instruction of the code once
+ * @param none
+ *
+ * @return true if some rule was applied
+ */
+bool Peephole::sweep() {
+    findTargets();
+    sweeps++;
+
+    auto changed = false;
+    Window at{};
+    for (size_t i = 0; i < code->size(); i++) {
+        for (size_t r = 0; r < RULE_COUNT && !dead[i]; r++) {
+            if (getWindow(i, RULES[r].window, at) < RULES[r].window)
+                continue;
+
+            if ((this->*RULES[r].apply)(at)) {
+                hits[r]++;
+                changed = true;
+            }
+        }
+    }
+
+    return changed;
+}
+
+
+/**
+ * @brief Take instructions of the window starting from the instruction
+ * @param[in]  t_first - first instruction of the window
+ * @param[in]  t_size  - instructions needed
+ * @param[out] t_at    - indices of instructions
+ *
+ * @return number of taken instructions, less than t_size at a jump target,
+ *         directive or the end of code
+ */
+size_t Peephole::getWindow(size_t t_first, size_t t_size, Window& t_at) const {
+    size_t count = 0;
+    t_at[count++] = t_first;
+
+    for (auto i = t_first + 1; i < code->size() && count < t_size; i++) {
+        if (isSkipped(i))
+            continue;
+
+        t_at[count++] = i;
+        if (!MachineCode::IsInstruction((*code)[i].op))
+            break;  // rules may look at it, but not over it
+    }
+
+    return count;
+}
+
+
+/**
+ * @brief Collect labels which are operands of jumps, other labels are skipped
+ *        by windows
+ * @param none
+ *
+ * @return none
+ */
+void Peephole::findTargets() {
+    targets.clear();
+    for (size_t i = 0; i < code->size(); i++) {
+        if (!dead[i] && MachineCode::IsJump((*code)[i].op))
+            targets.insert((*code)[i].src);
+    }
+
+    jumped.assign(code->size(), false);
+    for (size_t i = 0; i < code->size(); i++) {
+        if ((*code)[i].op == Opcode::label)
+            jumped[i] = (targets.count((*code)[i].src) != 0);
+    }
+}
+
+
+void Peephole::remove(size_t t_instr) {
+    dead[t_instr] = true;
+    removed++;
+}
+
+
+// removed instruction, separator or label which nothing jumps to
+bool Peephole::isSkipped(size_t t_instr) const {
+    auto& instr = (*code)[t_instr];
+    return dead[t_instr] || instr.op == Opcode::separator ||
+        (instr.op == Opcode::label && !jumped[t_instr]);
+}
+
+
+/**
+ * @brief Check that flags set by the instruction aren't read
+ * @param[in] t_instr - instruction
+ *
+ * @return true if the next flags reader comes after a writer of flags
+ * @note moves, 'lea', 'cltd', 'push', 'pop' and 'xchg' keep flags; jumps,
+ * 'setcc', 'cmovcc', labels of jumps and directives are taken as readers
+ */
+bool Peephole::isFlagsDead(size_t t_instr) const {
+    for (auto i = t_instr + 1; i < code->size(); i++) {
+        if (isSkipped(i))
+            continue;
+
+        switch ((*code)[i].op) {
+        case Opcode::add:
+        case Opcode::sub:
+        case Opcode::and_:
+        case Opcode::or_:
+        case Opcode::xor_:
+        case Opcode::imul:
+        case Opcode::idiv:
+        case Opcode::shl:
+        case Opcode::sar:
+        case Opcode::shr:
+        case Opcode::neg:
+        case Opcode::cmp:
+        case Opcode::leave:
+        case Opcode::ret:
+            return true;
+        case Opcode::mov:
+        case Opcode::movzb:
+        case Opcode::movb:
+        case Opcode::lea:
+        case Opcode::cltd:
+        case Opcode::push:
+        case Opcode::pop:
+        case Opcode::xchg:
+            continue;
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool Peephole::dropSeparator(const Window& t_at) {
+    if (!isOp(t_at[0], Opcode::separator))
+        return false;
+
+    remove(t_at[0]);
+    return true;
+}
+
+
+/**
+ * @brief push X; pop X are removed, push X; pop Y become mov X, Y of the
+ *        same width if one of them is a register
+ */
+bool Peephole::foldPushPop(const Window& t_at) {
+    auto& push = (*code)[t_at[0]];
+    auto& pop = (*code)[t_at[1]];
+    if (!isOp(t_at[0], Opcode::push) || !isOp(t_at[1], Opcode::pop) || push.wide != pop.wide)
+        return false;
+    if (push.src != pop.src && push.src.kind != Operand::reg && pop.src.kind != Operand::reg)
+        return false;
+
+    if (push.src == pop.src) {
+        remove(t_at[0]);
+        remove(t_at[1]);
+        return true;
+    }
+
+    pop = { Opcode::mov, push.wide, push.src, pop.src, {} };
+    remove(t_at[0]);
+    return true;
+}
+
+
+bool Peephole::dropSelfMove(const Window& t_at) {
+    auto& instr = (*code)[t_at[0]];
+    if (!isOp(t_at[0], Opcode::mov) || instr.wide || instr.src != instr.dst)
+        return false;
+
+    remove(t_at[0]);
+    return true;
+}
+
+
+/**
+ * @brief mov $0, R becomes shorter xor R, R if flags aren't read after it
+ */
+bool Peephole::zeroByXor(const Window& t_at) {
+    auto& instr = (*code)[t_at[0]];
+    if (!isOp(t_at[0], Opcode::mov) || !instr.src.IsImm(0) || instr.dst.kind != Operand::reg ||
+        !isFlagsDead(t_at[0]))
+        return false;
+
+    instr.op = Opcode::xor_;
+    instr.src = instr.dst;
+    return true;
+}
+
+
+/**
+ * @brief mov R, M; mov M, S take the value from the register: the second
+ *        move is removed if S is R or becomes mov R, S
+ */
+bool Peephole::forwardStore(const Window& t_at) {
+    if (!isOp(t_at[0], Opcode::mov) || !isOp(t_at[1], Opcode::mov))
+        return false;
+
+    auto& store = (*code)[t_at[0]];
+    auto& load = (*code)[t_at[1]];
+    if (store.wide || load.wide || store.src.kind != Operand::reg ||
+        store.dst.kind == Operand::reg || load.src != store.dst)
+        return false;
+
+    if (load.dst == store.src)
+        remove(t_at[1]);
+    else
+        load.src = store.src;
+    return true;
+}
+
+
+/**
+ * @brief The second of two same moves is removed if the source doesn't
+ *        depend on the destination
+ */
+bool Peephole::dropReload(const Window& t_at) {
+    if (!isOp(t_at[0], Opcode::mov) || !isOp(t_at[1], Opcode::mov))
+        return false;
+
+    auto& first = (*code)[t_at[0]];
+    auto& second = (*code)[t_at[1]];
+    if (first.wide || second.wide || first.src != second.src || first.dst != second.dst ||
+        (first.dst.kind == Operand::reg && first.src.DependsOn(first.dst.r)))
+        return false;
+
+    remove(t_at[1]);
+    return true;
+}
+
+
+/**
+ * @brief Operations which keep the operand are removed if flags aren't read
+ *        after them
+ */
+bool Peephole::dropNeutralOp(const Window& t_at) {
+    auto& instr = (*code)[t_at[0]];
+    if (instr.dst.kind == Operand::none)
+        return false;
+
+    auto op = instr.op;
+    auto neutral = (instr.src.IsImm(0) && (op == Opcode::add || op == Opcode::sub ||
+        op == Opcode::or_ || op == Opcode::xor_)) || (instr.src.IsImm(1) && op == Opcode::imul);
+    if (!neutral || !isFlagsDead(t_at[0]))
+        return false;
+
+    remove(t_at[0]);
+    return true;
+}
+
+
+/**
+ * @brief Jump to the label right after it is removed
+ */
+bool Peephole::dropJumpToNext(const Window& t_at) {
+    auto& jump = (*code)[t_at[0]];
+    auto& label = (*code)[t_at[1]];
+    if (!MachineCode::IsJump(jump.op) || label.op != Opcode::label || label.src != jump.src)
+        return false;
+
+    remove(t_at[0]);
+    return true;
+}
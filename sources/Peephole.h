@@ -0,0 +1,84 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include "MachineCode.h"
+
+/*
+ * Peephole pass over the instructions of MachineCode before they are printed.
+ * Every rule of the table looks at a window of the next instructions and
+ * deletes or rewrites them by their opcodes and operands. Separators and
+ * labels which nothing jumps to are skipped by the window, jump targets and
+ * directives end it.
+ *
+ * -O0 keeps the code, -O1 makes one sweep over it, -O2 repeats sweeps until
+ * no rule applies.
+ */
+class Peephole
+{
+public:
+	explicit Peephole(int t_level);
+
+	size_t			Run(MachineCode& t_code);	// number of removed instructions
+
+	size_t			GetRemoved() const { return removed; }
+	size_t			GetSweeps() const { return sweeps; }
+	size_t			GetRuleCount() const { return RULE_COUNT; }
+	const char*		GetRuleName(size_t t_rule) const { return RULES[t_rule].name; }
+	size_t			GetHits(size_t t_rule) const { return hits[t_rule]; }
+
+private:
+	static constexpr size_t MAX_WINDOW = 2;
+	static constexpr size_t RULE_COUNT = 8;
+
+	using Instr = MachineCode::Instr;
+	using Operand = MachineCode::Operand;
+	using Window = std::array<size_t, MAX_WINDOW>;	// instructions of window
+
+	struct Rule {
+		const char*	name;
+		size_t		window;		// instructions taken by rule
+		bool		(Peephole::*apply)(const Window& t_at);
+	};
+
+	struct LabelHash {
+		size_t	operator()(const Operand& t_label) const {
+			return (static_cast<size_t>(t_label.name) << 32) ^
+				(static_cast<size_t>(t_label.value) << 3) ^ static_cast<size_t>(t_label.label_kind);
+		}
+	};
+
+	static const std::array<Rule, RULE_COUNT> RULES;
+
+	int										level;
+	std::vector<Instr>*						code{ nullptr };
+	std::vector<bool>						dead;		// removed instructions
+	std::vector<bool>						jumped;		// labels which are targets of jumps
+	std::unordered_set<Operand, LabelHash>	targets;	// labels of jumps
+	std::array<size_t, RULE_COUNT>			hits{};
+	size_t									removed{ 0 };
+	size_t									sweeps{ 0 };
+
+	bool		sweep();
+	size_t		getWindow(size_t t_first, size_t t_size, Window& t_at) const;
+	void		findTargets();
+	void		remove(size_t t_instr);
+	bool		isSkipped(size_t t_instr) const;
+	bool		isFlagsDead(size_t t_instr) const;
+	bool		isOp(size_t t_instr, Opcode t_op) const { return (*code)[t_instr].op == t_op; }
+
+	bool		dropSeparator(const Window& t_at);
+	bool		foldPushPop(const Window& t_at);
+	bool		dropSelfMove(const Window& t_at);
+	bool		zeroByXor(const Window& t_at);
+	bool		forwardStore(const Window& t_at);
+	bool		dropReload(const Window& t_at);
+	bool		dropNeutralOp(const Window& t_at);
+	bool		dropJumpToNext(const Window& t_at);
+};
+
+#endif // !PEEPHOLE_H
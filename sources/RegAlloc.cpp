@@ -0,0 +1,419 @@
+#include "RegAlloc.h"
+#include <algorithm>
+
+
+/**
+ * @brief Give locations to values of code
+ * @param[in] t_code    - code in order of blocks
+ * @param[in] t_compare - block -> number of instructions (but phis) before its
+ *                        comparison, its operands are read there
+ * @param[in] t_fused   - value -> comparison which only selects after it read
+ *                        from flags, it has no location
+ *
+ * @return none
+ */
+void RegAlloc::Allocate(const SsaCode& t_code, const std::vector<uint32_t>& t_compare,
+                        const std::vector<bool>& t_fused) {
+    code = &t_code;
+    fused = &t_fused;
+    auto count = t_code.GetValueCount();
+    locations.assign(count, { Location::none, 0 });
+    intervals.assign(count, { 0, 0 });
+    positions.assign(count, 0);
+    hints.assign(count, SsaCode::NO_VALUE);
+    remat.assign(count, false);
+    divisions.clear();
+    slot_count = 0;
+    spilled = 0;
+
+    // %eax is scratch, %edx goes last as 'idivl' takes it, %r11 is the base
+    // of array which is indexed on x86-64
+    auto indexed = false;
+    for (auto b : t_code.GetOrder()) {
+        for (auto value : t_code.GetBlock(b).code) {
+            auto& inst = t_code.GetInst(value);
+            indexed |= (inst.op == SsaOp::load || inst.op == SsaOp::store) && inst.b != SsaCode::NO_VALUE;
+        }
+    }
+    regs.clear();
+    for (size_t r = 1; r < target.GetRegCount(); r++) {
+        if (r != edx && !(indexed && r == r11d))
+            regs.push_back(static_cast<Reg>(r));
+    }
+    regs.push_back(edx);
+    taken.assign(REG_COUNT, {});
+    slot_taken.clear();
+
+    numberPositions(t_compare);
+    findIntervals();
+    scan();
+}
+
+
+/**
+ * @brief Check if location keeps a value at position
+ * @param[in] t_location - register or slot
+ * @param[in] t_pos      - position of code
+ *
+ * @return true if any interval in the location covers position
+ */
+bool RegAlloc::IsTaken(Location t_location, uint32_t t_pos) const {
+    const std::vector<Interval>* list;
+    if (t_location.kind == Location::reg)
+        list = &taken[t_location.n];
+    else if (t_location.kind == Location::slot)
+        list = &slot_taken[t_location.n];
+    else
+        return false;
+
+    // intervals of location don't overlap and go by start
+    auto pos = std::upper_bound(list->begin(), list->end(), t_pos,
+        [](uint32_t t_at, const Interval& t_interval) { return t_at < t_interval.first; });
+    return pos != list->begin() && std::prev(pos)->second >= t_pos;
+}
+
+
+bool RegAlloc::needsLocation(value_t t_value) const {
+    switch (code->GetInst(t_value).op) {
+    case SsaOp::constant:
+    case SsaOp::address:
+    case SsaOp::store:
+    case SsaOp::nop:
+        return false;
+    case SsaOp::compare:
+        return !(*fused)[t_value];
+    default:
+        return true;
+    }
+}
+
+
+/**
+ * @brief Number positions of code: phis are defined at the start of block,
+ *        an instruction reads its operands at its position and defines its
+ *        value after it, copies to phis of successors read at the end
+ * @param[in] t_compare - number of instructions before comparison of block
+ *
+ * @return none
+ */
+void RegAlloc::numberPositions(const std::vector<uint32_t>& t_compare) {
+    auto blocks = code->GetBlockCount();
+    block_start.assign(blocks, 0);
+    block_end.assign(blocks, 0);
+    compare_pos.assign(blocks, 0);
+
+    std::vector<bool> stored(Interner::Get().GetCount(), false);
+    uint32_t pos = 0;
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        block_start[b] = pos;
+        pos += 2;
+
+        uint32_t idx = 0;
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::phi)
+                continue;
+
+            if (idx++ == t_compare[b] && block.exit == SsaExit::branch) {
+                compare_pos[b] = pos;
+                pos += 2;
+            }
+            positions[value] = pos;
+            if (inst.op == SsaOp::div)
+                divisions.push_back(value);
+            else if (inst.op == SsaOp::store)
+                stored[inst.sym] = true;
+            pos += 2;
+        }
+        if (idx <= t_compare[b] && block.exit == SsaExit::branch) {
+            compare_pos[b] = pos;
+            pos += 2;
+        }
+        block_end[b] = pos;
+        pos += 2;
+    }
+
+    for (auto b : code->GetOrder()) {
+        for (auto value : code->GetBlock(b).code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::load && inst.size == 4 && inst.b == SsaCode::NO_VALUE && !stored[inst.sym])
+                remat[value] = true;
+        }
+    }
+}
+
+
+/**
+ * @brief Find live intervals: a value is live from its definition to its uses,
+ *        and in every block on the way back from a use to the definition
+ * @param none
+ *
+ * @return none
+ */
+void RegAlloc::findIntervals() {
+    // uses in other blocks than definition, they are walked by value
+    std::vector<std::pair<value_t, block_t>> far_uses;
+    auto use = [&](value_t t_value, block_t t_block, uint32_t t_pos) {
+        if (!needsLocation(t_value))
+            return;
+        auto& interval = intervals[t_value];
+        interval.second = std::max(interval.second, t_pos);
+        if (code->GetInst(t_value).block != t_block)
+            far_uses.emplace_back(t_value, t_block);
+    };
+
+    for (auto b : code->GetOrder()) {
+        for (auto value : code->GetBlock(b).code) {
+            auto& inst = code->GetInst(value);
+            auto def = (inst.op == SsaOp::phi) ? block_start[b] : positions[value] + 1;
+            intervals[value] = { def, def };
+        }
+    }
+
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op != SsaOp::phi) {
+                code->ForOperands(inst, [&](value_t t_arg) { use(t_arg, b, positions[value]); });
+                continue;
+            }
+
+            auto& args = code->GetArgs(value);
+            for (size_t i = 0; i < args.size(); i++) {
+                auto pred = block.preds[i];
+                use(args[i], pred, block_end[pred]);
+                if (hints[args[i]] == SsaCode::NO_VALUE)
+                    hints[args[i]] = value;
+            }
+        }
+        if (block.exit == SsaExit::branch) {
+            use(block.lhs, b, compare_pos[b]);
+            use(block.rhs, b, compare_pos[b]);
+        }
+    }
+
+    std::sort(far_uses.begin(), far_uses.end());
+    far_uses.erase(std::unique(far_uses.begin(), far_uses.end()), far_uses.end());
+
+    // the value is live into the block of use and out of its predecessors
+    std::vector<value_t> mark(code->GetBlockCount(), SsaCode::NO_VALUE);
+    std::vector<block_t> work;
+    for (auto [value, block] : far_uses) {
+        auto def = code->GetInst(value).block;
+        auto& interval = intervals[value];
+        if (mark[block] == value)
+            continue;
+
+        mark[block] = value;
+        work.push_back(block);
+        while (!work.empty()) {
+            auto b = work.back();
+            work.pop_back();
+            interval.first = std::min(interval.first, block_start[b]);
+            for (auto pred : code->GetBlock(b).preds) {
+                interval.second = std::max(interval.second, block_end[pred]);
+                if (pred != def && mark[pred] != value) {
+                    mark[pred] = value;
+                    work.push_back(pred);
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Check if value can't be in %edx: it's live over a division, but the
+ *        dividend which dies at it. Division by a constant reads the dividend
+ *        after it takes %edx
+ * @param[in] t_value - value with interval
+ *
+ * @return true if %edx is taken by a division in the interval
+ * @note Intervals come by start, the first division in it is found from the
+ * one of the previous interval
+ */
+bool RegAlloc::isAcrossDivision(value_t t_value) {
+    auto [first, last] = intervals[t_value];
+    while (next_division < divisions.size() && positions[divisions[next_division]] < first)
+        next_division++;
+    auto pos = divisions.begin() + next_division;
+    if (pos == divisions.end() || positions[*pos] > last)
+        return false;
+
+    // the division is the last use, it's fine for the dividend only
+    auto& inst = code->GetInst(*pos);
+    return positions[*pos] != last || inst.a != t_value || inst.b == t_value
+        || code->GetInst(inst.b).op == SsaOp::constant;
+}
+
+
+/**
+ * @brief Choose a free register for value: register of an operand which dies,
+ *        of its phi or of an argument of phi, else the first free one
+ * @param[in] t_value  - value to place
+ * @param[in] t_free   - register -> it's free
+ * @param[in] t_no_edx - value is live across a division
+ *
+ * @return register or REG_COUNT if no register is free
+ */
+Reg RegAlloc::choose(value_t t_value, const std::vector<bool>& t_free, bool t_no_edx) const {
+    auto fits = [&](value_t t_other) {
+        if (t_other == SsaCode::NO_VALUE || locations[t_other].kind != Location::reg)
+            return false;
+        auto r = locations[t_other].n;
+        return t_free[r] && !(t_no_edx && r == edx);
+    };
+
+    auto& inst = code->GetInst(t_value);
+    if (inst.op == SsaOp::copy || inst.op == SsaOp::check || SsaCode::IsBinary(inst.op)) {
+        if (fits(inst.a))
+            return static_cast<Reg>(locations[inst.a].n);
+        if (SsaCode::IsCommutative(inst.op) && fits(inst.b))
+            return static_cast<Reg>(locations[inst.b].n);
+    }
+    if (inst.op == SsaOp::select) {
+        if (fits(inst.a))
+            return static_cast<Reg>(locations[inst.a].n);
+        if (fits(inst.b))
+            return static_cast<Reg>(locations[inst.b].n);
+    }
+    if (fits(hints[t_value]))
+        return static_cast<Reg>(locations[hints[t_value]].n);
+    if (inst.op == SsaOp::phi) {
+        for (auto arg : code->GetArgs(t_value)) {
+            if (fits(arg))
+                return static_cast<Reg>(locations[arg].n);
+        }
+    }
+
+    // a phi leaves the register of an argument to the phi of that argument
+    auto is_wanted = [&](Reg t_reg) {
+        if (inst.op != SsaOp::phi)
+            return false;
+        for (auto value : code->GetBlock(inst.block).code) {
+            if (code->GetInst(value).op != SsaOp::phi)
+                break;
+            for (auto arg : code->GetArgs(value)) {
+                if (value != t_value && locations[arg].kind == Location::reg && locations[arg].n == t_reg)
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    auto found = REG_COUNT;
+    for (auto r : regs) {
+        if (!t_free[r] || (t_no_edx && r == edx))
+            continue;
+        if (!is_wanted(r))
+            return r;
+        if (found == REG_COUNT)
+            found = r;
+    }
+    return found;
+}
+
+
+/**
+ * @brief Put value to memory for its whole interval: a load of memory which
+ *        isn't stored stays there, else the first slot which is free
+ * @param[in] t_value - value without register
+ *
+ * @return none
+ */
+void RegAlloc::spill(value_t t_value) {
+    if (remat[t_value]) {
+        locations[t_value] = { Location::memory, 0 };
+        return;
+    }
+
+    // slots are taken in any order, a slot fits if it's free before the start
+    auto interval = intervals[t_value];
+    size_t slot = 0;
+    while (slot < slot_taken.size() && !slot_taken[slot].empty()
+        && slot_taken[slot].back().second >= interval.first)
+        slot++;
+    if (slot == slot_taken.size())
+        slot_taken.emplace_back();
+
+    slot_taken[slot].push_back(interval);
+    locations[t_value] = { Location::slot, static_cast<uint32_t>(slot) };
+    slot_count = slot_taken.size();
+    spilled++;
+}
+
+
+/**
+ * @brief Linear scan over intervals by start
+ * @param none
+ *
+ * @return none
+ */
+void RegAlloc::scan() {
+    std::vector<value_t> list;
+    for (auto b : code->GetOrder()) {
+        for (auto value : code->GetBlock(b).code) {
+            auto op = code->GetInst(value).op;
+            if (op == SsaOp::constant || op == SsaOp::address)
+                locations[value] = { Location::imm, 0 };
+            else if (needsLocation(value))
+                list.push_back(value);
+        }
+    }
+    // a definition dominates its uses and goes before them in order of code,
+    // so the list is sorted by start
+
+    // memory which isn't stored is spilled first, it costs no store
+    auto weight = [this](value_t t_value) {
+        return static_cast<uint64_t>(intervals[t_value].second) + (remat[t_value] ? (1ull << 32) : 0);
+    };
+
+    next_division = 0;
+    std::vector<bool> free(REG_COUNT, false);
+    for (auto r : regs)
+        free[r] = true;
+    std::vector<value_t> active;
+
+    for (auto value : list) {
+        auto first = intervals[value].first;
+        active.erase(std::remove_if(active.begin(), active.end(), [&](value_t t_value) {
+            if (intervals[t_value].second >= first)
+                return false;
+            free[locations[t_value].n] = true;
+            return true;
+        }), active.end());
+
+        auto no_edx = isAcrossDivision(value);
+        auto r = choose(value, free, no_edx);
+        if (r != REG_COUNT) {
+            locations[value] = { Location::reg, r };
+            free[r] = false;
+            active.push_back(value);
+            continue;
+        }
+
+        // the interval which ends last gives its register
+        auto victim = active.end();
+        for (auto pos = active.begin(); pos != active.end(); ++pos) {
+            if (no_edx && locations[*pos].n == edx)
+                continue;
+            if (victim == active.end() || weight(*pos) > weight(*victim))
+                victim = pos;
+        }
+        if (victim == active.end() || weight(*victim) <= weight(value)) {
+            spill(value);
+            continue;
+        }
+
+        locations[value] = locations[*victim];
+        spill(*victim);
+        *victim = value;
+    }
+
+    for (auto value : list) {
+        if (locations[value].kind == Location::reg)
+            taken[locations[value].n].push_back(intervals[value]);
+    }
+}
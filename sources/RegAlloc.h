@@ -0,0 +1,86 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SsaCode.h"
+#include "Target.h"
+
+/*
+ * Linear scan register allocation over SsaCode in order of code. Every value
+ * has one live interval from its definition to its last use, a value which is
+ * live in a block of loop covers the whole loop. Intervals are taken by start:
+ * a value gets the register of an operand which dies at its definition or of
+ * its phi if it's free, else any free register. When all registers are taken,
+ * the interval which ends last is spilled to a static slot for its whole life.
+ *
+ * %eax is not allocated, it's the scratch register of lowering and 'idivl'.
+ * %edx may be taken by a value which isn't live across a division, %r11 is
+ * left for the base of array on x86-64. Loads of 4 bytes of memory which is
+ * never stored and isn't indexed are spilled to the memory itself,
+ * constants are immediate operands and take nothing, neither do comparisons
+ * which lowering leaves in flags.
+ */
+class RegAlloc
+{
+public:
+	using value_t = SsaCode::value_t;
+	using block_t = SsaCode::block_t;
+
+	struct Location {
+		enum Kind : uint8_t {
+			none,
+			reg,
+			slot,		// spill slot by number
+			memory,		// memory of load, it's never stored
+			imm,		// constant or address
+		};
+
+		Kind		kind;
+		uint32_t	n;			// register or slot
+	};
+
+	explicit RegAlloc(const Target& t_target) : target(t_target) {};
+
+	void		Allocate(const SsaCode& t_code, const std::vector<uint32_t>& t_compare,
+					const std::vector<bool>& t_fused);
+
+	Location	GetLocation(value_t t_value) const { return locations[t_value]; }
+	bool		IsTaken(Location t_location, uint32_t t_pos) const;
+	uint32_t	GetStart(block_t t_block) const { return block_start[t_block]; }
+	size_t		GetSlotCount() const { return slot_count; }
+	size_t		GetSpilled() const { return spilled; }
+
+private:
+	using Interval = std::pair<uint32_t, uint32_t>;	// [first, last] positions
+
+	const Target&			target;
+	const SsaCode*			code{ nullptr };
+	const std::vector<bool>*	fused{ nullptr };	// comparison is kept in flags
+	std::vector<Location>	locations;
+	std::vector<Interval>	intervals;
+	std::vector<uint32_t>	block_start;		// definition of phis
+	std::vector<uint32_t>	block_end;			// copies into phis of successors
+	std::vector<uint32_t>	compare_pos;
+	std::vector<uint32_t>	positions;			// value -> its instruction
+	std::vector<value_t>	divisions;			// 'div' in order of code
+	size_t					next_division{ 0 };	// first one not before the interval of scan
+	std::vector<value_t>	hints;				// value -> phi which takes it
+	std::vector<bool>		remat;				// load of memory which isn't stored
+	std::vector<std::vector<Interval>>	taken;	// register -> intervals in it
+	std::vector<std::vector<Interval>>	slot_taken;
+	std::vector<Reg>		regs;				// allocated, in order of choice
+	size_t					slot_count{ 0 };
+	size_t					spilled{ 0 };
+
+	void		numberPositions(const std::vector<uint32_t>& t_compare);
+	void		findIntervals();
+	void		scan();
+	Reg			choose(value_t t_value, const std::vector<bool>& t_free, bool t_no_edx) const;
+	void		spill(value_t t_value);
+	bool		isAcrossDivision(value_t t_value);
+	bool		needsLocation(value_t t_value) const;
+};
+
+#endif // !REGALLOC_H
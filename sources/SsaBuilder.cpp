@@ -0,0 +1,622 @@
+#include "SsaBuilder.h"
+#include <algorithm>
+#include <stdexcept>
+
+using block_t = SsaCode::block_t;
+using value_t = SsaCode::value_t;
+
+
+SsaBuilder::SsaBuilder(const FlatTree& t_ast, const SymbolTable& t_symbols, SsaCode& t_code, bool t_check,
+    bool t_promote)
+    : ast(t_ast), symbols(t_symbols), code(t_code), check(t_check), promote(t_promote),
+      vars(t_promote ? Interner::Get().GetCount() : 0, UNKNOWN) {}
+
+
+/**
+ * @brief Build code of statements, the last block stores assigned variables
+ * @param[in] t_first - first statement of the compound of program
+ *
+ * @return none
+ * @note Error in the tree throws std::out_of_range
+ */
+void SsaBuilder::Build(node_ref t_first) {
+    code.Reserve(ast.size()); // about a value per node of tree
+    if (promote)
+        findAssigned();
+    entry = newBlock(LabelKind::block, 0);
+    code.Place(entry);
+    current = entry;
+
+    stack.emplace_back();
+    stack.back().node = t_first;
+    while (!stack.empty()) {
+        auto& frame = stack.back();
+        switch (frame.stage) {
+        case Frame::statements: {
+            // statements after 'break' are not reached
+            if (current == SsaCode::NO_BLOCK || isEnd(frame.node)) {
+                stack.pop_back();
+                break;
+            }
+            auto node = frame.node;
+            frame.node = node->GetRightNode();
+            if (node->GetLeftNode() != nullptr)
+                startStatement(node->GetLeftNode());
+            break;
+        }
+        case Frame::statement: {
+            auto node = frame.node;
+            stack.pop_back();
+            startStatement(node);
+            break;
+        }
+        case Frame::after_then:
+            afterThen(frame);
+            break;
+        case Frame::after_else:
+            afterElse(frame);
+            break;
+        case Frame::after_body:
+            afterBody(frame);
+            break;
+        }
+    }
+
+    if (current == SsaCode::NO_BLOCK) {
+        current = newBlock(LabelKind::block, 0);
+        code.Place(current);
+    }
+    for (uint32_t var = 0; var < var_syms.size(); var++) {
+        auto value = env[var];
+        if (written[var] && value != SsaCode::NO_VALUE && value != loaded[var])
+            code.Add(current, SsaOp::store, value, SsaCode::NO_VALUE, 0, var_syms[var]);
+    }
+    code.SetReturn(current);
+}
+
+
+/**
+ * @brief Build statement, nested statements are left on the stack
+ * @param[in] t_node - assign, if, for, compound or break
+ *
+ * @return none
+ */
+void SsaBuilder::startStatement(node_ref t_node) {
+    switch (t_node->GetKind()) {
+    case NodeKind::assign:
+        write(t_node->GetLeftNode(), assigned(t_node->GetRightNode()));
+        break;
+    case NodeKind::if_op:
+        startIf(t_node);
+        break;
+    case NodeKind::for_op:
+        startFor(t_node);
+        break;
+    case NodeKind::compound:
+        stack.emplace_back();
+        stack.back().node = t_node->GetRightNode();
+        break;
+    case NodeKind::break_op:
+        addBreak();
+        break;
+    default:
+        throw std::out_of_range("<E> SsaBuilder: unknown statement");
+    }
+}
+
+
+// statement of if or for is started from the stack, not from the call stack
+void SsaBuilder::pushStatement(node_ref t_node) {
+    stack.emplace_back();
+    stack.back().stage = Frame::statement;
+    stack.back().node = t_node;
+}
+
+
+/**
+ * @brief Build condition of if and the first block of 'then'
+ * @param[in] t_node - if
+ *
+ * @return none
+ * @note The block of 'else' or the end of if without 'else' is the second
+ * target of branch
+ */
+void SsaBuilder::startIf(node_ref t_node) {
+    auto then_op = t_node->GetRightNode();
+    if (t_node->GetLeftNode() == nullptr || then_op == nullptr || then_op->GetKind() != NodeKind::then_op)
+        throw std::out_of_range("<E> SsaBuilder: error in if");
+
+    num_if++;
+    auto has_else = (then_op->GetRightNode() != nullptr);
+    auto then_block = newBlock(LabelKind::block, 0);
+
+    Frame frame;
+    frame.stage = Frame::after_then;
+    frame.node = t_node;
+    frame.next = newBlock(has_else ? LabelKind::nope : LabelKind::end, num_if);
+    condition(t_node->GetLeftNode(), then_block, frame.next);
+    if (has_else)
+        frame.env = env;
+    else {
+        for (auto pred : code.GetBlock(frame.next).preds)
+            frame.edges.push_back({ pred, env });
+    }
+
+    code.Place(then_block);
+    current = then_block;
+    stack.push_back(std::move(frame));
+    if (then_op->GetLeftNode() != nullptr)
+        pushStatement(then_op->GetLeftNode());
+}
+
+
+void SsaBuilder::afterThen(Frame& t_frame) {
+    auto else_op = t_frame.node->GetRightNode()->GetRightNode();
+    if (else_op == nullptr) {
+        auto end = t_frame.next;
+        auto edges = std::move(t_frame.edges);
+        stack.pop_back();
+        jump(end, edges);
+        join(end, edges);
+        return;
+    }
+
+    if (current != SsaCode::NO_BLOCK) {
+        t_frame.end = newBlock(LabelKind::end, code.GetBlock(t_frame.next).num);
+        jump(t_frame.end, t_frame.edges);
+    }
+    current = t_frame.next;
+    env = std::move(t_frame.env);
+    env.resize(var_syms.size(), SsaCode::NO_VALUE);
+    code.Place(current);
+
+    t_frame.stage = Frame::after_else;
+    if (else_op->GetLeftNode() != nullptr)
+        pushStatement(else_op->GetLeftNode());
+}
+
+
+void SsaBuilder::afterElse(Frame& t_frame) {
+    if (current != SsaCode::NO_BLOCK && t_frame.end == SsaCode::NO_BLOCK)
+        t_frame.end = newBlock(LabelKind::end, code.GetBlock(t_frame.next).num);
+
+    auto end = t_frame.end;
+    auto edges = std::move(t_frame.edges);
+    stack.pop_back();
+    jump(end, edges);
+    if (!edges.empty())
+        join(end, edges);
+}
+
+
+/**
+ * @brief Find variables assigned in every for by one pass over the tree
+ *
+ * @return none
+ * @note A loop takes the variables of its nested loops instead of their nodes,
+ * so deep nesting costs the number of phis of heads, not the size of bodies.
+ * Variables are in order of their first assignment in the loop
+ */
+void SsaBuilder::findAssigned() {
+    std::vector<std::pair<index_t, symbol_t>> pending; // assigned in loops which aren't reached yet
+    std::vector<uint32_t> seen(vars.size(), UINT32_MAX); // symbol -> last loop which took it
+    for (index_t i = 0; i < ast.size(); i++) {
+        auto kind = ast.GetKind(i);
+        if (kind == NodeKind::assign && ast.GetKind(ast.GetLeft(i)) == NodeKind::id
+            && ast.GetSymbol(ast.GetLeft(i)) < seen.size())
+            pending.emplace_back(i, ast.GetSymbol(ast.GetLeft(i)));
+        if (kind != NodeKind::for_op)
+            continue;
+
+        // nodes of the loop are its subtree, the tail of pending
+        auto first = ast.GetFirst(i);
+        auto begin = pending.end();
+        while (begin != pending.begin() && std::prev(begin)->first >= first)
+            --begin;
+
+        auto loop = static_cast<uint32_t>(for_nodes.size());
+        std::vector<symbol_t> assigned;
+        for (auto it = begin; it != pending.end(); ++it) {
+            if (seen[it->second] != loop) {
+                seen[it->second] = loop;
+                assigned.push_back(it->second);
+            }
+        }
+        pending.erase(begin, pending.end());
+        for (auto sym : assigned)
+            pending.emplace_back(i, sym);
+        for_nodes.push_back(i);
+        for_assigned.push_back(std::move(assigned));
+    }
+}
+
+
+/**
+ * @brief Build start of for: bound, the first value of variable, the guard
+ *        which skips the loop and the head of loop
+ * @param[in] t_node - for
+ *
+ * @return none
+ * @note Both values are computed once, the bound first. The head takes a phi
+ * for every variable which is assigned in the loop
+ */
+void SsaBuilder::startFor(node_ref t_node) {
+    auto range = t_node->GetLeftNode();     // to or downto
+    if (range == nullptr || range->GetLeftNode() == nullptr || t_node->GetRightNode() == nullptr)
+        throw std::out_of_range("<E> SsaBuilder: error in for");
+
+    auto init = range->GetLeftNode();       // assign of the first value
+    auto downto = (range->GetKind() == NodeKind::downto);
+    num_for++;
+
+    Frame frame;
+    frame.stage = Frame::after_body;
+    frame.node = t_node;
+    frame.bound = expression(range->GetRightNode());
+    auto start = assigned(init->GetRightNode());
+    write(init->GetLeftNode(), start);
+
+    frame.next = newBlock(LabelKind::loop_done, num_for);
+    auto pre = newBlock(LabelKind::block, 0);
+    code.SetBranch(current, downto ? OpKind::lt : OpKind::gt, start, frame.bound, frame.next, pre);
+    frame.edges.push_back({ current, env });
+    code.Place(pre);
+
+    frame.end = newBlock(LabelKind::loop, num_for);
+    code.SetJump(pre, frame.end);
+    code.Place(frame.end);
+    current = frame.end;
+
+    // variables in memory take no phis
+    if (promote) {
+        auto loop = std::lower_bound(for_nodes.begin(), for_nodes.end(), t_node.GetIndex()) - for_nodes.begin();
+        for (auto sym : for_assigned[loop]) {
+            auto var = getVar(sym);
+            if (var == NO_VAR || (env[var] != SsaCode::NO_VALUE && code.GetInst(env[var]).block == current))
+                continue; // head has its phi
+
+            auto phi = code.AddPhi(current);
+            code.AddArg(phi, resolve(var, env[var]));
+            env[var] = phi;
+            frame.phis.emplace_back(var, phi);
+        }
+    }
+
+    loops.push_back(stack.size());
+    stack.push_back(std::move(frame));
+    pushStatement(t_node->GetRightNode());
+}
+
+
+/**
+ * @brief Build end of for body: compare of the variable with the bound before
+ *        the step and the branch back to the head
+ * @param[inout] t_frame - for
+ *
+ * @return none
+ * @note After the loop the variable is one step past the bound
+ */
+void SsaBuilder::afterBody(Frame& t_frame) {
+    auto range = t_frame.node->GetLeftNode();
+    auto control = range->GetLeftNode()->GetLeftNode();
+    auto downto = (range->GetKind() == NodeKind::downto);
+
+    if (current != SsaCode::NO_BLOCK) {
+        auto old = read(control);
+        auto step = code.AddConstant(current, downto ? -1 : 1);
+        write(control, code.Add(current, SsaOp::add, old, step));
+        code.SetBranch(current, downto ? OpKind::gt : OpKind::lt, old, t_frame.bound, t_frame.end, t_frame.next);
+        for (auto& [var, phi] : t_frame.phis)
+            code.AddArg(phi, resolve(var, env[var]));
+        t_frame.edges.push_back({ current, env });
+    }
+
+    auto exit = t_frame.next;
+    auto edges = std::move(t_frame.edges);
+    loops.pop_back();
+    stack.pop_back();
+    join(exit, edges);
+}
+
+
+// 'break' out of loops changes nothing
+void SsaBuilder::addBreak() {
+    if (current == SsaCode::NO_BLOCK || loops.empty())
+        return;
+
+    auto& loop = stack[loops.back()];
+    jump(loop.next, loop.edges);
+}
+
+
+/**
+ * @brief Start block where edges join, variables which come with different
+ *        values take phis
+ * @param[in]    t_block - block of join
+ * @param[inout] t_edges - edges in order of predecessors of block
+ *
+ * @return none
+ */
+void SsaBuilder::join(block_t t_block, std::vector<Edge>& t_edges) {
+    code.Place(t_block);
+    current = t_block;
+
+    auto count = var_syms.size();
+    for (auto& edge : t_edges)
+        edge.env.resize(count, SsaCode::NO_VALUE);
+
+    env = std::move(t_edges.front().env);
+    if (t_edges.size() == 1)
+        return;
+
+    for (uint32_t var = 0; var < count; var++) {
+        auto same = true;
+        for (size_t i = 1; i < t_edges.size() && same; i++)
+            same = (t_edges[i].env[var] == env[var]);
+        if (same)
+            continue;
+
+        auto phi = code.AddPhi(t_block);
+        code.AddArg(phi, resolve(var, env[var]));
+        for (size_t i = 1; i < t_edges.size(); i++)
+            code.AddArg(phi, resolve(var, t_edges[i].env[var]));
+        env[var] = phi;
+    }
+}
+
+
+block_t SsaBuilder::newBlock(LabelKind t_kind, size_t t_num) {
+    // blocks without label of statement are named by number
+    return code.AddBlock(t_kind, (t_kind == LabelKind::block) ? code.GetBlockCount() : t_num);
+}
+
+
+// jump from the current block into a join, the rest isn't reached
+void SsaBuilder::jump(block_t t_to, std::vector<Edge>& t_edges) {
+    if (current == SsaCode::NO_BLOCK)
+        return;
+
+    code.SetJump(current, t_to);
+    t_edges.push_back({ current, env });
+    current = SsaCode::NO_BLOCK;
+}
+
+
+/**
+ * @brief Build expression, operators of post-order come after their operands
+ * @param[in] t_node - root of expression
+ *
+ * @return value of expression
+ */
+value_t SsaBuilder::expression(node_ref t_node) {
+    auto root = t_node.GetIndex();
+    auto is_inner = [&](index_t t_child) {
+        auto kind = ast.GetKind(t_child);
+        return kind == NodeKind::operation || kind == NodeKind::array_elem;
+    };
+    if (!is_inner(root))
+        return leaf(root);
+
+    auto first = ast.GetFirst(root);
+    values.resize(root - first + 1);
+    auto get = [&](index_t t_child) {
+        return is_inner(t_child) ? values[t_child - first] : leaf(t_child);
+    };
+
+    for (auto i = first; i <= root; i++) {
+        if (ast.GetKind(i) == NodeKind::array_elem) {
+            auto index = ast.GetRight(i);
+            values[i - first] = access(ast.GetNode(i),
+                (ast.GetKind(index) == NodeKind::constant) ? SsaCode::NO_VALUE : get(index), SsaCode::NO_VALUE);
+            continue;
+        }
+        if (ast.GetKind(i) != NodeKind::operation)
+            continue;
+        auto a = get(ast.GetLeft(i));
+        auto b = get(ast.GetRight(i));
+        auto op = ast.GetOperation(i);
+        values[i - first] = IsComparison(op)
+            ? code.Add(current, SsaOp::compare, a, b, static_cast<int>(op))
+            : code.Add(current, getOp(op), a, b);
+    }
+    return values[root - first];
+}
+
+
+// value of assignment, a variable is copied so every assignment defines a value
+value_t SsaBuilder::assigned(node_ref t_node) {
+    auto value = expression(t_node);
+    if (t_node->GetKind() == NodeKind::id && getVar(t_node->GetSymbol()) != NO_VAR)
+        value = code.Add(current, SsaOp::copy, value);
+    return value;
+}
+
+
+value_t SsaBuilder::leaf(index_t t_node) {
+    switch (ast.GetKind(t_node)) {
+    case NodeKind::constant:
+    case NodeKind::boolean:
+        return code.AddConstant(current, ast.GetNumber(t_node));
+    case NodeKind::id:
+        return read(ast.GetNode(t_node));
+    default:
+        throw std::out_of_range("<E> SsaBuilder: invalid operand");
+    }
+}
+
+
+/**
+ * @brief Build branches of if: 'and' and 'or' are short-circuit, a comparison
+ *        is a branch, other value is true if it isn't zero
+ * @param[in] t_node - condition
+ * @param[in] t_then - block if it's true
+ * @param[in] t_else - block if it's false
+ *
+ * @return none
+ * @note Blocks of right operands are placed after the left ones, the last
+ * branch is the current block
+ */
+void SsaBuilder::condition(node_ref t_node, block_t t_then, block_t t_else) {
+    std::vector<Test> tests{ { t_node, t_then, t_else, SsaCode::NO_BLOCK } };
+    while (!tests.empty()) {
+        auto test = tests.back();
+        tests.pop_back();
+        if (test.start != SsaCode::NO_BLOCK) {
+            code.Place(test.start);
+            current = test.start;
+        }
+
+        auto node = test.node;
+        auto op = (node->GetKind() == NodeKind::operation) ? node->GetOperation() : OpKind::none;
+        if (op == OpKind::and_ || op == OpKind::or_) {
+            auto right = newBlock(LabelKind::block, 0);
+            tests.push_back({ node->GetRightNode(), test.then, test.other, right });
+            if (op == OpKind::and_)
+                tests.push_back({ node->GetLeftNode(), right, test.other, SsaCode::NO_BLOCK });
+            else
+                tests.push_back({ node->GetLeftNode(), test.then, right, SsaCode::NO_BLOCK });
+            continue;
+        }
+
+        if (IsComparison(op)) {
+            auto lhs = expression(node->GetLeftNode());
+            auto rhs = expression(node->GetRightNode());
+            code.SetBranch(current, op, lhs, rhs, test.then, test.other);
+            continue;
+        }
+        auto value = expression(node);
+        code.SetBranch(current, OpKind::ne, value, code.AddConstant(current, 0), test.then, test.other);
+    }
+}
+
+
+value_t SsaBuilder::read(node_ref t_node) {
+    auto sym = t_node->GetSymbol();
+    auto var = getVar(sym);
+    if (var != NO_VAR)
+        return resolve(var, env[var]);
+
+    if (symbols.Find(sym) == nullptr)
+        return code.Add(current, SsaOp::address, SsaCode::NO_VALUE, SsaCode::NO_VALUE, 0, sym);
+
+    auto value = code.Add(current, SsaOp::load, SsaCode::NO_VALUE, SsaCode::NO_VALUE, 0, sym);
+    code.GetInst(value).size = getSize(sym);
+    return value;
+}
+
+
+// variable takes the value, other targets are stored
+void SsaBuilder::write(node_ref t_node, value_t t_value) {
+    if (t_node->GetKind() == NodeKind::array_elem) {
+        auto index = t_node->GetRightNode();
+        access(t_node, (index->GetKind() == NodeKind::constant) ? SsaCode::NO_VALUE : expression(index), t_value);
+        return;
+    }
+
+    auto var = getVar(t_node->GetSymbol());
+    if (var == NO_VAR) {
+        auto store = code.Add(current, SsaOp::store, t_value, SsaCode::NO_VALUE, 0, t_node->GetSymbol());
+        code.GetInst(store).size = getSize(t_node->GetSymbol());
+        return;
+    }
+    env[var] = t_value;
+    written[var] = true;
+}
+
+
+/**
+ * @brief Load or store array element: elements are counted from the low bound
+ *        of array, an index which isn't constant is scaled by the size of
+ *        element and checked by the range if it's asked
+ * @param[in] t_node  - array element
+ * @param[in] t_index - value of index, NO_VALUE - constant of the node
+ * @param[in] t_value - value to store, NO_VALUE - element is loaded
+ *
+ * @return load or store
+ */
+value_t SsaBuilder::access(node_ref t_node, value_t t_index, value_t t_value) {
+    auto sym = t_node->GetLeftNode()->GetSymbol();
+    auto* var = symbols.Find(sym);
+    auto size = getSize(sym);
+    auto offset = -size * var->range.first;
+    if (t_index == SsaCode::NO_VALUE) {
+        // a folded index may be out of range, it traps
+        auto number = t_node->GetRightNode()->GetNumber();
+        if (!check || (number >= var->range.first && number <= var->range.second))
+            offset += size * number;
+        else
+            t_index = code.AddConstant(current, number);
+    }
+    if (t_index != SsaCode::NO_VALUE && check) {
+        auto high = code.AddConstant(current, var->range.second);
+        t_index = code.Add(current, SsaOp::check, t_index, high, var->range.first);
+    }
+
+    auto op = (t_value == SsaCode::NO_VALUE) ? SsaOp::load : SsaOp::store;
+    auto value = code.Add(current, op, t_value, t_index, offset, sym);
+    code.GetInst(value).size = size;
+    return value;
+}
+
+
+// value of variable, the loaded one is added to the entry block once
+value_t SsaBuilder::resolve(uint32_t t_var, value_t t_value) {
+    if (t_value != SsaCode::NO_VALUE)
+        return t_value;
+
+    if (loaded[t_var] == SsaCode::NO_VALUE)
+        loaded[t_var] = code.Add(entry, SsaOp::load, SsaCode::NO_VALUE, SsaCode::NO_VALUE, 0, var_syms[t_var]);
+    return loaded[t_var];
+}
+
+
+/**
+ * @brief Get variable which is kept in values: declared integer, not array
+ * @param[in] t_sym - symbol of identifier
+ *
+ * @return number of variable or NO_VAR
+ */
+uint32_t SsaBuilder::getVar(symbol_t t_sym) {
+    if (t_sym >= vars.size())
+        return NO_VAR;
+    if (vars[t_sym] != UNKNOWN)
+        return vars[t_sym];
+
+    auto* var = symbols.Find(t_sym);
+    if (var == nullptr || var->isarray || var->type != VarType::integer)
+        return vars[t_sym] = NO_VAR;
+
+    vars[t_sym] = static_cast<uint32_t>(var_syms.size());
+    var_syms.push_back(t_sym);
+    loaded.push_back(SsaCode::NO_VALUE);
+    written.push_back(false);
+    env.push_back(SsaCode::NO_VALUE);
+    return vars[t_sym];
+}
+
+
+// bytes of memory of variable or of array element, undeclared names are 4
+uint8_t SsaBuilder::getSize(symbol_t t_sym) const {
+    auto* var = symbols.Find(t_sym);
+    return (var != nullptr && var->type == VarType::boolean) ? 1 : 4;
+}
+
+
+bool SsaBuilder::isEnd(node_ref t_node) {
+    return t_node->GetKind() == NodeKind::end || t_node->GetKind() == NodeKind::end_program;
+}
+
+
+SsaOp SsaBuilder::getOp(OpKind t_op) {
+    switch (t_op) {
+    case OpKind::add:  return SsaOp::add;
+    case OpKind::sub:  return SsaOp::sub;
+    case OpKind::mul:  return SsaOp::mul;
+    case OpKind::div:  return SsaOp::div;
+    case OpKind::and_: return SsaOp::and_;
+    case OpKind::or_:  return SsaOp::or_;
+    case OpKind::xor_: return SsaOp::xor_;
+    default:
+        throw std::out_of_range("<E> SsaBuilder: invalid operation");
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef SSABUILDER_H
+#define SSABUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FlatTree.h"
+#include "SsaCode.h"
+#include "SymbolTable.h"
+
+/*
+ * Lowering of the statements of syntax tree to SsaCode. Integer variables are
+ * renamed to values while statements are walked: the current block keeps the
+ * value of every variable, joins of 'if' and the exit of 'for' take a phi for a
+ * variable which comes with different values, the head of loop takes a phi for
+ * every variable assigned in the loop. A variable is loaded once in the entry
+ * block and stored in the last block if it's assigned. Without promotion (-O0)
+ * every variable stays in memory: a read is a load and a write is a store, so
+ * there are no phis and only the bound of 'for' lives past its statement.
+ *
+ * 'for' is rotated: the guard skips the loop, the body is followed by the
+ * compare of the variable with the bound and the step. 'break' jumps to the
+ * exit of the innermost loop, statements after it are not reached. Nested
+ * statements wait on an explicit stack like in the parser.
+ *
+ * 'and' and 'or' of the condition of if are short-circuit: every comparison is
+ * a branch of its own block. Comparisons in other expressions are values of 0
+ * or 1, booleans are loaded and stored as bytes. Array elements are addressed
+ * from the low bound of array, an index which isn't constant may be checked.
+ */
+class SsaBuilder
+{
+public:
+	SsaBuilder(const FlatTree& t_ast, const SymbolTable& t_symbols, SsaCode& t_code, bool t_check = false,
+		bool t_promote = true);
+
+	void		Build(FlatTree::Ref t_first);	// statements from the first of program
+
+private:
+	using node_ref = FlatTree::Ref;
+	using index_t = FlatTree::index_t;
+	using value_t = SsaCode::value_t;
+	using block_t = SsaCode::block_t;
+	using Env = std::vector<value_t>;			// value of every variable, NO_VALUE - loaded one
+
+	static constexpr uint32_t NO_VAR = UINT32_MAX;
+	static constexpr uint32_t UNKNOWN = UINT32_MAX - 1;
+
+	// edge into a join with values of variables on it
+	struct Edge {
+		block_t		from;
+		Env			env;
+	};
+
+	// operand of 'and' or 'or' in condition, the right one starts its block
+	struct Test {
+		node_ref	node;
+		block_t		then;
+		block_t		other;
+		block_t		start;				// NO_BLOCK - the current one
+	};
+
+	struct Frame {
+		enum Stage : uint8_t {
+			statements,		// statements of compound
+			statement,		// statement nested in if or for
+			after_then,
+			after_else,
+			after_body,		// body of for
+		};
+
+		Stage		stage{ statements };
+		node_ref	node;					// next statement, if or for
+		block_t		next{ SsaCode::NO_BLOCK };	// if: 'else' or end, for: exit
+		block_t		end{ SsaCode::NO_BLOCK };	// if: end, for: head of loop
+		std::vector<Edge>	edges;			// into 'next'
+		Env			env;					// if: values on the edge into 'else'
+		std::vector<std::pair<uint32_t, value_t>>	phis;	// for: variable and its phi in head
+		value_t		bound{ SsaCode::NO_VALUE };
+	};
+
+	const FlatTree&				ast;
+	const SymbolTable&			symbols;
+	SsaCode&					code;
+	bool						check;		// index of array is checked at run time
+	bool						promote;	// integer variables are kept in values
+	block_t						entry{ SsaCode::NO_BLOCK };
+	block_t						current{ SsaCode::NO_BLOCK };	// NO_BLOCK - code isn't reached
+	Env							env;
+	std::vector<uint32_t>		vars;		// symbol -> variable, NO_VAR isn't a value
+	std::vector<symbol_t>		var_syms;	// variable -> symbol
+	std::vector<value_t>		loaded;		// variable -> its load in entry
+	std::vector<bool>			written;	// variable is assigned
+	std::vector<Frame>			stack;
+	std::vector<size_t>			loops;		// frames of for, innermost last
+	std::vector<value_t>		values;		// values of expression nodes
+	std::vector<index_t>		for_nodes;	// for in post-order
+	std::vector<std::vector<symbol_t>>	for_assigned;	// for -> variables assigned in it
+	size_t						num_if{ 0 };
+	size_t						num_for{ 0 };
+
+	void		findAssigned();
+	void		startStatement(node_ref t_node);
+	void		pushStatement(node_ref t_node);
+	void		startIf(node_ref t_node);
+	void		startFor(node_ref t_node);
+	void		afterThen(Frame& t_frame);
+	void		afterElse(Frame& t_frame);
+	void		afterBody(Frame& t_frame);
+	void		addBreak();
+	void		join(block_t t_block, std::vector<Edge>& t_edges);
+	block_t		newBlock(LabelKind t_kind, size_t t_num);
+	void		jump(block_t t_to, std::vector<Edge>& t_edges);
+
+	value_t		expression(node_ref t_node);
+	value_t		assigned(node_ref t_node);
+	value_t		leaf(index_t t_node);
+	void		condition(node_ref t_node, block_t t_then, block_t t_else);
+	value_t		read(node_ref t_node);
+	void		write(node_ref t_node, value_t t_value);
+	value_t		access(node_ref t_node, value_t t_index, value_t t_value);
+	value_t		resolve(uint32_t t_var, value_t t_value);
+	uint32_t	getVar(symbol_t t_sym);
+	uint8_t		getSize(symbol_t t_sym) const;
+
+	static bool	isEnd(node_ref t_node);
+	static SsaOp	getOp(OpKind t_op);
+};
+
+#endif // !SSABUILDER_H
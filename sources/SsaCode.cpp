@@ -0,0 +1,237 @@
+#include "SsaCode.h"
+#include <algorithm>
+
+
+SsaCode::block_t SsaCode::AddBlock(LabelKind t_kind, size_t t_num) {
+    blocks.emplace_back();
+    blocks.back().kind = t_kind;
+    blocks.back().num = static_cast<uint32_t>(t_num);
+    return static_cast<block_t>(blocks.size() - 1);
+}
+
+
+SsaCode::value_t SsaCode::Add(block_t t_block, SsaOp t_op, value_t t_a, value_t t_b,
+                              int t_imm, symbol_t t_sym) {
+    auto value = static_cast<value_t>(insts.size());
+    insts.push_back({ t_op, t_block, t_a, t_b, t_imm, t_sym });
+    blocks[t_block].code.push_back(value);
+    return value;
+}
+
+
+/**
+ * @brief Add phi without arguments, they are added in order of predecessors
+ * @param[in] t_block - block with no instructions but phis
+ *
+ * @return value of phi
+ */
+SsaCode::value_t SsaCode::AddPhi(block_t t_block) {
+    args.emplace_back();
+    return Add(t_block, SsaOp::phi, NO_VALUE, NO_VALUE, static_cast<int>(args.size() - 1));
+}
+
+
+SsaCode::value_t SsaCode::AddSelect(block_t t_block, value_t t_c, value_t t_a, value_t t_b) {
+    auto value = Add(t_block, SsaOp::select, t_a, t_b);
+    insts[value].c = t_c;
+    return value;
+}
+
+
+void SsaCode::SetJump(block_t t_block, block_t t_to) {
+    auto& block = blocks[t_block];
+    block.exit = SsaExit::jump;
+    block.succ = { t_to, NO_BLOCK };
+    blocks[t_to].preds.push_back(t_block);
+}
+
+
+void SsaCode::SetBranch(block_t t_block, OpKind t_cond, value_t t_lhs, value_t t_rhs,
+                        block_t t_then, block_t t_else) {
+    auto& block = blocks[t_block];
+    block.exit = SsaExit::branch;
+    block.cond = t_cond;
+    block.lhs = t_lhs;
+    block.rhs = t_rhs;
+    block.succ = { t_then, t_else };
+    blocks[t_then].preds.push_back(t_block);
+    blocks[t_else].preds.push_back(t_block);
+}
+
+
+/**
+ * @brief Remove predecessor of block with its arguments of phis
+ * @param[in] t_from - predecessor, its exit is changed by caller
+ * @param[in] t_to   - successor
+ *
+ * @return none
+ */
+void SsaCode::RemoveEdge(block_t t_from, block_t t_to) {
+    auto& preds = blocks[t_to].preds;
+    auto pos = std::find(preds.begin(), preds.end(), t_from);
+    if (pos == preds.end())
+        return;
+
+    auto idx = pos - preds.begin();
+    preds.erase(pos);
+    for (auto value : blocks[t_to].code) {
+        if (insts[value].op != SsaOp::phi)
+            break;
+        auto& list = args[insts[value].imm];
+        list.erase(list.begin() + idx);
+    }
+}
+
+
+void SsaCode::Remove(value_t t_value) {
+    auto& inst = insts[t_value];
+    if (inst.op == SsaOp::phi)
+        args[inst.imm].clear();
+    inst.op = SsaOp::nop;
+}
+
+
+void SsaCode::Compact() {
+    order.erase(std::remove_if(order.begin(), order.end(),
+        [this](block_t t_block) { return blocks[t_block].removed; }), order.end());
+
+    // a phi replaced by a constant goes after the phis
+    for (auto b : order) {
+        auto& code = blocks[b].code;
+        code.erase(std::remove_if(code.begin(), code.end(),
+            [this](value_t t_value) { return insts[t_value].op == SsaOp::nop; }), code.end());
+        auto is_phi = [this](value_t t_value) { return insts[t_value].op == SsaOp::phi; };
+        if (!std::is_partitioned(code.begin(), code.end(), is_phi))
+            std::stable_partition(code.begin(), code.end(), is_phi);
+    }
+}
+
+
+size_t SsaCode::GetPhiCount() const {
+    size_t count = 0;
+    for (auto b : order) {
+        for (auto value : blocks[b].code) {
+            if (insts[value].op != SsaOp::phi)
+                break;
+            count++;
+        }
+    }
+    return count;
+}
+
+
+bool SsaCode::IsCommutative(SsaOp t_op) {
+    switch (t_op) {
+    case SsaOp::add:
+    case SsaOp::mul:
+    case SsaOp::and_:
+    case SsaOp::or_:
+    case SsaOp::xor_:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * @brief Compute operator as the code does it at run time
+ * @param[in]  t_op     - binary operator
+ * @param[in]  t_a      - left operand
+ * @param[in]  t_b      - right operand
+ * @param[out] t_result - value of operator
+ *
+ * @return false if it isn't known: division by zero
+ */
+bool SsaCode::Compute(SsaOp t_op, int t_a, int t_b, int& t_result) {
+    auto a = static_cast<uint32_t>(t_a);
+    auto b = static_cast<uint32_t>(t_b);
+    uint32_t r;
+
+    switch (t_op) {
+    case SsaOp::add:  r = a + b; break;
+    case SsaOp::sub:  r = a - b; break;
+    case SsaOp::mul:  r = a * b; break;
+    case SsaOp::and_: r = a & b; break;
+    case SsaOp::or_:  r = a | b; break;
+    case SsaOp::xor_: r = a ^ b; break;
+    case SsaOp::div:
+        // truncated toward zero, -2^31 div -1 wraps like negl
+        if (b == 0)
+            return false;
+        r = (t_b == -1) ? 0u - a : static_cast<uint32_t>(t_a / t_b);
+        break;
+    default:
+        return false;
+    }
+
+    t_result = static_cast<int>(r);
+    return true;
+}
+
+
+bool SsaCode::Compare(OpKind t_cond, int t_lhs, int t_rhs) {
+    switch (t_cond) {
+    case OpKind::eq: return t_lhs == t_rhs;
+    case OpKind::ne: return t_lhs != t_rhs;
+    case OpKind::gt: return t_lhs > t_rhs;
+    case OpKind::lt: return t_lhs < t_rhs;
+    case OpKind::ge: return t_lhs >= t_rhs;
+    case OpKind::le: return t_lhs <= t_rhs;
+    default:         return false;
+    }
+}
+
+
+/**
+ * @brief Print blocks of code in order, it's for debugging of passes
+ * @param[out] t_out - stream of text
+ *
+ * @return none
+ */
+void SsaCode::Print(std::ostream& t_out) const {
+    static const char* const OPS[] = {
+        "const", "addr", "load", "store", "copy", "phi",
+        "add", "sub", "mul", "div", "and", "or", "xor", "cmp", "select", "check", "nop" };
+    static const char* const CONDS[] = { "?", "=", "<>", ">", "<", ">=", "<=" };
+
+    for (auto b : order) {
+        auto& block = blocks[b];
+        t_out << "b" << b << ":";
+        for (auto pred : block.preds)
+            t_out << " b" << pred;
+        t_out << "\n";
+
+        for (auto value : block.code) {
+            auto& inst = insts[value];
+            t_out << "  v" << value << " = " << OPS[static_cast<int>(inst.op)];
+            if (inst.op == SsaOp::phi) {
+                for (auto arg : args[inst.imm])
+                    t_out << " v" << arg;
+            }
+            else {
+                ForOperands(inst, [&](value_t t_arg) { t_out << " v" << t_arg; });
+                if (inst.sym != NO_SYMBOL)
+                    t_out << " " << Interner::Get().GetName(inst.sym) << "+" << inst.imm;
+                else if (inst.op == SsaOp::constant || inst.op == SsaOp::check)
+                    t_out << " " << inst.imm;
+                else if (inst.op == SsaOp::compare)
+                    t_out << " " << CONDS[inst.imm];
+            }
+            t_out << "\n";
+        }
+
+        switch (block.exit) {
+        case SsaExit::jump:
+            t_out << "  jump b" << block.succ[0] << "\n";
+            break;
+        case SsaExit::branch:
+            t_out << "  if v" << block.lhs << " " << CONDS[static_cast<int>(block.cond)] << " v"
+                << block.rhs << " b" << block.succ[0] << " else b" << block.succ[1] << "\n";
+            break;
+        case SsaExit::ret:
+            t_out << "  ret\n";
+            break;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef SSACODE_H
+#define SSACODE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Interner.h"
+#include "MachineCode.h"
+#include "Operators.h"
+
+enum class SsaOp : uint8_t {
+	constant,		// number in imm
+	address,		// address of undeclared name sym, '$name'
+	load,			// size bytes of memory of sym + imm + size * b, b is the index or NO_VALUE
+	store,			// a to size bytes of memory of sym + imm + size * b, it has no value
+	copy,			// a
+	phi,			// argument for every predecessor of block, list in imm
+	add, sub, mul, div, and_, or_, xor_,	// a op b: 32-bit, 'div' is signed
+	compare,		// 1 if 'a cond b' (signed), else 0, cond in imm
+	select,			// a if c isn't 0, else b
+	check,			// a, the program traps if it isn't in [imm, b], b is a constant
+	nop,			// removed by a pass
+};
+
+enum class SsaExit : uint8_t {
+	jump,			// to succ[0]
+	branch,			// to succ[0] if 'lhs cond rhs' (signed), else to succ[1]
+	ret,			// end of program
+};
+
+/*
+ * Program in SSA form between the syntax tree and MachineCode. Every value is
+ * defined once by the instruction with its number, instructions sit in basic
+ * blocks with phis first, a block ends by a jump, a branch on comparison of two
+ * values or the return. Integer variables are values, they are loaded from
+ * '.data'/'.bss' before the first read and stored at the end of program. Arrays,
+ * booleans and undeclared names stay explicit loads and stores, a boolean is a
+ * byte of 0 or 1. An index of array which isn't constant is a value, it may go
+ * through a check of the range of array.
+ *
+ * Blocks are kept in order of the source, it's the order of code. Removed
+ * instructions become nop and leave their block, removed blocks leave the order.
+ */
+class SsaCode
+{
+public:
+	using value_t = uint32_t;
+	using block_t = uint32_t;
+	static constexpr value_t NO_VALUE = UINT32_MAX;
+	static constexpr block_t NO_BLOCK = UINT32_MAX;
+
+	struct Inst {
+		SsaOp		op;
+		block_t		block;
+		value_t		a;
+		value_t		b;
+		int			imm;
+		symbol_t	sym;
+		value_t		c{ NO_VALUE };		// condition of select
+		uint8_t		size{ 4 };			// bytes of load and store
+	};
+
+	struct Block {
+		std::vector<value_t>	code;		// phis first
+		std::vector<block_t>	preds;		// order of arguments of phis
+		std::array<block_t, 2>	succ{ NO_BLOCK, NO_BLOCK };
+		SsaExit		exit{ SsaExit::ret };
+		OpKind		cond{ OpKind::none };
+		value_t		lhs{ NO_VALUE };
+		value_t		rhs{ NO_VALUE };
+		LabelKind	kind;				// label of code
+		uint32_t	num;
+		bool		removed{ false };
+	};
+
+	block_t		AddBlock(LabelKind t_kind, size_t t_num);
+	void		Place(block_t t_block) { order.push_back(t_block); }	// next block of code
+	value_t		Add(block_t t_block, SsaOp t_op, value_t t_a = NO_VALUE, value_t t_b = NO_VALUE,
+					int t_imm = 0, symbol_t t_sym = NO_SYMBOL);
+	value_t		AddConstant(block_t t_block, int t_number) { return Add(t_block, SsaOp::constant, NO_VALUE, NO_VALUE, t_number); }
+	value_t		AddPhi(block_t t_block);
+	value_t		AddSelect(block_t t_block, value_t t_c, value_t t_a, value_t t_b);
+	void		AddArg(value_t t_phi, value_t t_arg) { args[insts[t_phi].imm].push_back(t_arg); }
+
+	void		SetJump(block_t t_block, block_t t_to);
+	void		SetBranch(block_t t_block, OpKind t_cond, value_t t_lhs, value_t t_rhs,
+					block_t t_then, block_t t_else);
+	void		SetReturn(block_t t_block) { blocks[t_block].exit = SsaExit::ret; }
+	void		RemoveEdge(block_t t_from, block_t t_to);
+	void		Remove(value_t t_value);
+	void		Compact();				// drops nop and removed blocks, phis go first
+
+	Inst&					GetInst(value_t t_value) { return insts[t_value]; }
+	const Inst&				GetInst(value_t t_value) const { return insts[t_value]; }
+	Block&					GetBlock(block_t t_block) { return blocks[t_block]; }
+	const Block&			GetBlock(block_t t_block) const { return blocks[t_block]; }
+	std::vector<value_t>&	GetArgs(value_t t_phi) { return args[insts[t_phi].imm]; }
+	const std::vector<value_t>&	GetArgs(value_t t_phi) const { return args[insts[t_phi].imm]; }
+	const std::vector<block_t>&	GetOrder() const { return order; }
+	std::vector<block_t>&	GetOrder() { return order; }
+	size_t					GetValueCount() const { return insts.size(); }
+	size_t					GetBlockCount() const { return blocks.size(); }
+	size_t					GetPhiCount() const;
+	void					Reserve(size_t t_values) { insts.reserve(t_values); }
+
+	// operands of instruction which are values, phi arguments aren't in them
+	template <typename F> void ForOperands(const Inst& t_inst, F t_fn) const {
+		if (t_inst.a != NO_VALUE) t_fn(t_inst.a);
+		if (t_inst.b != NO_VALUE) t_fn(t_inst.b);
+		if (t_inst.c != NO_VALUE) t_fn(t_inst.c);
+	}
+
+	static bool		IsBinary(SsaOp t_op) { return t_op >= SsaOp::add && t_op <= SsaOp::xor_; }
+	static bool		IsCommutative(SsaOp t_op);
+	static bool		Compute(SsaOp t_op, int t_a, int t_b, int& t_result);
+	static bool		Compare(OpKind t_cond, int t_lhs, int t_rhs);
+
+	void			Print(std::ostream& t_out) const;
+
+private:
+	std::vector<Inst>					insts;
+	std::vector<Block>					blocks;
+	std::vector<std::vector<value_t>>	args;		// arguments of phis
+	std::vector<block_t>				order;		// blocks in order of code
+};
+
+#endif // !SSACODE_H
@@ -0,0 +1,1065 @@
+#include "SsaLowering.h"
+#include <algorithm>
+#include <array>
+
+
+/**
+ * @brief Lower code to instructions of machine after the entry of program
+ * @param[in] t_code - optimized code, it isn't changed
+ *
+ * @return none
+ */
+void SsaLowering::Lower(const SsaCode& t_code) {
+    code = &t_code;
+    names.assign(Interner::Get().GetCount(), 0);
+    extra_labels = 0;
+    trap = {};
+
+    findCompares();
+    findFused();
+    alloc.Allocate(t_code, compare, fused);
+    addSlots();
+    findLabels();
+
+    auto& order = t_code.GetOrder();
+    Operand end{};
+    for (size_t i = 0; i < order.size(); i++) {
+        auto b = order[i];
+        auto next = (i + 1 < order.size()) ? order[i + 1] : SsaCode::NO_BLOCK;
+        if (labeled[b]) {
+            machine.AddSeparator();
+            machine.AddLabel(getLabel(b));
+        }
+
+        lowerBlock(b, next);
+        if (t_code.GetBlock(b).exit == SsaExit::ret && (next != SsaCode::NO_BLOCK || trap.kind != Operand::none)) {
+            if (end.kind == Operand::none)
+                end = newLabel();
+            jump(Opcode::jmp, end);
+        }
+    }
+
+    // checks of index jump out of the code to the trap
+    if (trap.kind != Operand::none) {
+        machine.AddSeparator();
+        machine.AddLabel(trap);
+        machine.Add(Opcode::ud2);
+    }
+    if (end.kind != Operand::none)
+        machine.AddLabel(end);
+    machine.AddSeparator();
+}
+
+
+/**
+ * @brief Find the place of comparison in blocks with branch: after the last
+ *        instruction of its operands if the rest keeps flags, else at the end
+ * @param none
+ *
+ * @return none
+ */
+void SsaLowering::findCompares() {
+    compare.assign(code->GetBlockCount(), NO_COMPARE);
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        if (block.exit != SsaExit::branch)
+            continue;
+
+        uint32_t count = 0;
+        uint32_t after = 0;			// instructions up to the last operand
+        bool keeps = true;			// instructions after it keep flags
+        for (auto value : block.code) {
+            auto op = code->GetInst(value).op;
+            if (op == SsaOp::phi)
+                continue;
+
+            count++;
+            if (value == block.lhs || value == block.rhs) {
+                after = count;
+                keeps = true;
+                continue;
+            }
+
+            switch (op) {
+            case SsaOp::constant:
+            case SsaOp::address:
+            case SsaOp::load:
+            case SsaOp::store:
+            case SsaOp::copy:
+                break;
+            default:
+                keeps = keeps && isStep(*code, value);
+                break;
+            }
+        }
+        compare[b] = keeps ? after : count;
+    }
+}
+
+
+/**
+ * @brief Find comparisons which are used only by selects right after them,
+ *        'cmovcc' of the selects read flags of the comparison
+ * @param none
+ *
+ * @return none
+ * @note Uses are counted only if some comparison has selects after it
+ */
+void SsaLowering::findFused() {
+    fused.assign(code->GetValueCount(), false);
+    std::vector<std::pair<value_t, uint32_t>> candidates; // comparison and selects after it
+    for (auto b : code->GetOrder()) {
+        auto& list = code->GetBlock(b).code;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (code->GetInst(list[i]).op != SsaOp::compare)
+                continue;
+
+            uint32_t selects = 0;
+            for (auto j = i + 1; j < list.size(); j++, selects++) {
+                auto& inst = code->GetInst(list[j]);
+                if (inst.op != SsaOp::select || inst.c != list[i])
+                    break;
+            }
+            if (selects != 0)
+                candidates.emplace_back(list[i], selects);
+        }
+    }
+    if (candidates.empty())
+        return; // no selects, code of -O0
+
+    std::vector<uint32_t> uses(code->GetValueCount(), 0);
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::phi) {
+                for (auto arg : code->GetArgs(value))
+                    uses[arg]++;
+            }
+            else
+                code->ForOperands(inst, [&](value_t t_arg) { uses[t_arg]++; });
+        }
+        if (block.exit == SsaExit::branch) {
+            uses[block.lhs]++;
+            uses[block.rhs]++;
+        }
+    }
+    for (auto [value, selects] : candidates)
+        fused[value] = (selects == uses[value]);
+}
+
+
+/**
+ * @brief Find blocks which may be jumped to: a block has a predecessor which
+ *        isn't the previous block or the previous block branches
+ * @param none
+ *
+ * @return none
+ */
+void SsaLowering::findLabels() {
+    labeled.assign(code->GetBlockCount(), false);
+    auto prev = SsaCode::NO_BLOCK;
+    for (auto b : code->GetOrder()) {
+        for (auto pred : code->GetBlock(b).preds) {
+            if (pred != prev || code->GetBlock(pred).exit != SsaExit::jump)
+                labeled[b] = true;
+        }
+        prev = b;
+    }
+}
+
+
+// names of slots are kept by the lowering, the code has views of them
+void SsaLowering::addSlots() {
+    slots.clear();
+    slot_names.clear();
+    divisor_used = false;
+
+    auto count = alloc.GetSlotCount();
+    slots.reserve(count + 1);
+    for (size_t i = 0; i < count; i++) {
+        slots.push_back("_slot" + std::to_string(i) + "_");
+        slot_names.push_back(machine.AddName(slots.back()));
+    }
+}
+
+
+/**
+ * @brief Slot of immediate divisor, 'idivl' takes no immediate
+ * @param none
+ *
+ * @return memory operand
+ */
+SsaLowering::Operand SsaLowering::getDivisor() {
+    if (!divisor_used) {
+        divisor_used = true;
+        slots.push_back("_divisor_");
+        slot_names.push_back(machine.AddName(slots.back()));
+    }
+    return Operand::MakeMem(slot_names.back());
+}
+
+
+void SsaLowering::lowerBlock(block_t t_block, block_t t_next) {
+    auto& block = code->GetBlock(t_block);
+    uint32_t idx = 0;
+    bool keep_flags = false;
+    for (auto value : block.code) {
+        if (code->GetInst(value).op == SsaOp::phi)
+            continue;
+
+        if (idx++ == compare[t_block]) {
+            compareValues(block.lhs, block.rhs, block.cond);
+            keep_flags = true;
+        }
+        lowerInst(value, keep_flags);
+    }
+
+    switch (block.exit) {
+    case SsaExit::ret:
+        break;
+    case SsaExit::jump: {
+        std::vector<Move> moves;
+        getMoves(t_block, block.succ[0], moves);
+        addMoves(moves);
+        if (block.succ[0] != t_next)
+            jump(Opcode::jmp, getLabel(block.succ[0]));
+        break;
+    }
+    case SsaExit::branch:
+        if (idx <= compare[t_block])
+            compareValues(block.lhs, block.rhs, block.cond);
+        lowerBranch(t_block, t_next);
+        break;
+    }
+}
+
+
+/**
+ * @brief Lower instruction to moves and operations
+ * @param[in] t_value      - instruction
+ * @param[in] t_keep_flags - it's between comparison and jump
+ *
+ * @return none
+ */
+void SsaLowering::lowerInst(value_t t_value, bool t_keep_flags) {
+    auto& inst = code->GetInst(t_value);
+    switch (inst.op) {
+    case SsaOp::load:
+        lowerLoad(t_value);
+        break;
+    case SsaOp::store:
+        lowerStore(t_value);
+        break;
+    case SsaOp::copy:
+        move(getOperand(inst.a), getOperand(t_value));
+        break;
+    case SsaOp::div:
+        lowerDivision(t_value);
+        break;
+    case SsaOp::compare:
+        lowerCompare(t_value);
+        break;
+    case SsaOp::select:
+        lowerSelect(t_value);
+        break;
+    case SsaOp::check:
+        lowerCheck(t_value);
+        break;
+    case SsaOp::add:
+    case SsaOp::sub:
+    case SsaOp::mul:
+    case SsaOp::and_:
+    case SsaOp::or_:
+    case SsaOp::xor_:
+        if (t_keep_flags)
+            lowerStep(t_value);
+        else
+            lowerBinary(t_value);
+        break;
+    default:
+        break;          // constants are operands, phis are copies of edges
+    }
+}
+
+
+// a byte is zero-extended, memory which is never stored is read in place
+void SsaLowering::lowerLoad(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    if (alloc.GetLocation(t_value).kind == RegAlloc::Location::memory)
+        return;
+
+    auto dst = getOperand(t_value);
+    auto memory = getMemory(inst);
+    if (inst.size == 4) {
+        move(memory, dst);
+        return;
+    }
+    auto result = (dst.kind == Operand::reg) ? dst : Operand::MakeReg(eax);
+    machine.Add(Opcode::movzb, memory, result);
+    move(result, dst);
+}
+
+
+/**
+ * @brief Lower store: a byte is stored from %al or as an immediate, memory
+ *        goes through %eax
+ * @param[in] t_value - store
+ *
+ * @return none
+ * @note On x86 an index in memory is loaded to a register which is saved on
+ * the stack if the stored value takes %eax
+ */
+void SsaLowering::lowerStore(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto src = getOperand(inst.a);
+    auto eax_reg = Operand::MakeReg(eax);
+    auto through_eax = (inst.size == 4) ? (src.kind == Operand::mem) : !src.IsImm(src.value);
+    Operand saved{};
+    if (through_eax && !target.IsWide() && inst.b != SsaCode::NO_VALUE && getOperand(inst.b).kind == Operand::mem) {
+        saved = Operand::MakeReg(src.IsReg(ebx) ? esi : ebx);
+        machine.Add(Opcode::push, saved);
+    }
+
+    auto memory = getMemory(inst, (saved.kind == Operand::reg) ? saved.r : eax);
+    if (inst.size == 4)
+        move(src, memory);
+    else if (src.IsImm(src.value))
+        machine.Add(Opcode::movb, Operand::MakeImm(src.value & 0xff), memory);
+    else {
+        move(src, eax_reg);
+        machine.Add(Opcode::movb, eax_reg, memory);
+    }
+    if (saved.kind == Operand::reg)
+        machine.Add(Opcode::pop, saved);
+}
+
+
+/**
+ * @brief Lower check of index: the index minus the low bound is compared
+ *        with the length of array without sign, 'ja' goes to the trap
+ * @param[in] t_value - check
+ *
+ * @return none
+ */
+void SsaLowering::lowerCheck(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto index = getOperand(inst.a);
+    auto high = code->GetInst(inst.b).imm;
+    auto eax_reg = Operand::MakeReg(eax);
+    auto x = index;
+    if (inst.imm != 0 && index.kind == Operand::reg) {
+        machine.Add(Opcode::lea, Operand::MakeAddress(index.r, -inst.imm), eax_reg);
+        x = eax_reg;
+    }
+    else if (inst.imm != 0 || index.kind == Operand::imm) {
+        move(index, eax_reg);
+        if (inst.imm != 0)
+            machine.Add(Opcode::sub, Operand::MakeImm(inst.imm), eax_reg);
+        x = eax_reg;
+    }
+    machine.Add(Opcode::cmp, Operand::MakeImm(high - inst.imm), x);
+
+    if (trap.kind == Operand::none)
+        trap = Operand::MakeLabel(LabelKind::name, 0, machine.AddName(TRAP_NAME));
+    jump(Opcode::ja, trap);
+    move(index, getOperand(t_value));
+}
+
+
+/**
+ * @brief Lower two-operand operation: the operation is done in the place of
+ *        value if it's the place of an operand, else through %eax
+ * @param[in] t_value - binary operation
+ *
+ * @return none
+ */
+void SsaLowering::lowerBinary(value_t t_value) {
+    static const Opcode OPS[] = { Opcode::add, Opcode::sub, Opcode::imul, Opcode::idiv,
+        Opcode::and_, Opcode::or_, Opcode::xor_ };
+
+    auto& inst = code->GetInst(t_value);
+    if (inst.op == SsaOp::mul && lowerMultiply(t_value))
+        return;
+
+    auto op = OPS[static_cast<int>(inst.op) - static_cast<int>(SsaOp::add)];
+    auto a = getOperand(inst.a);
+    auto b = getOperand(inst.b);
+    auto dst = getOperand(t_value);
+
+    // 'imull' writes a register, two memory operands aren't allowed
+    auto fits = [&](const Operand& t_src) {
+        return dst.kind == Operand::reg || (op != Opcode::imul && t_src.kind != Operand::mem);
+    };
+
+    if (dst == a && fits(b)) {
+        machine.Add(op, b, dst);
+    }
+    else if (SsaCode::IsCommutative(inst.op) && dst == b && fits(a)) {
+        machine.Add(op, a, dst);
+    }
+    else if (dst.kind == Operand::reg && dst != b) {
+        move(a, dst);
+        machine.Add(op, b, dst);
+    }
+    else {
+        auto scratch = Operand::MakeReg(eax);
+        move(a, scratch);
+        machine.Add(op, b, scratch);
+        move(scratch, dst);
+    }
+}
+
+
+// add or sub of a constant, 'lea' does it without flags
+bool SsaLowering::isStep(const SsaCode& t_code, value_t t_value) {
+    auto& inst = t_code.GetInst(t_value);
+    auto is_constant = [&](value_t t_arg) { return t_code.GetInst(t_arg).op == SsaOp::constant; };
+    auto is_address = [&](value_t t_arg) { return t_code.GetInst(t_arg).op == SsaOp::address; };
+
+    if (inst.op == SsaOp::add)
+        return (is_constant(inst.b) && !is_address(inst.a)) || (is_constant(inst.a) && !is_address(inst.b));
+    if (inst.op == SsaOp::sub)
+        return is_constant(inst.b) && !is_address(inst.a);
+    return false;
+}
+
+
+/**
+ * @brief Lower add or sub of a constant by 'lea', flags of comparison stay
+ * @param[in] t_value - operation of isStep()
+ *
+ * @return none
+ */
+void SsaLowering::lowerStep(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto var = inst.a;
+    auto step = inst.b;
+    if (code->GetInst(step).op != SsaOp::constant)
+        std::swap(var, step);
+
+    auto disp = code->GetInst(step).imm;
+    if (inst.op == SsaOp::sub)
+        disp = static_cast<int>(0u - static_cast<uint32_t>(disp));
+
+    auto src = getOperand(var);
+    auto dst = getOperand(t_value);
+    if (src.kind == Operand::imm) {
+        move(Operand::MakeImm(static_cast<int>(static_cast<uint32_t>(src.value) + static_cast<uint32_t>(disp))), dst);
+        return;
+    }
+
+    auto base = src.r;
+    if (src.kind != Operand::reg) {
+        base = eax;
+        move(src, Operand::MakeReg(eax));
+    }
+
+    auto result = (dst.kind == Operand::reg) ? dst : Operand::MakeReg(eax);
+    machine.Add(Opcode::lea, Operand::MakeAddress(base, disp), result);
+    move(result, dst);
+}
+
+
+/**
+ * @brief Lower multiplication by a constant without 'imull': shift for a
+ *        power of two, 'lea' for 3, 5 and 9, then a shift or one more 'lea'
+ * @param[in] t_value - multiplication
+ *
+ * @return false if it's left to 'imull'
+ * @note 6 is lea (R,R,2) + shl, 45 is two 'lea'. Negative factors take 'negl'
+ * after the power of two only
+ */
+bool SsaLowering::lowerMultiply(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto x = getOperand(inst.a);
+    auto factor = getOperand(inst.b);
+    if (!factor.IsImm(factor.value))
+        std::swap(x, factor);
+    if (!factor.IsImm(factor.value) || x.kind == Operand::imm)
+        return false;
+
+    auto dst = getOperand(t_value);
+    if (factor.value == 0) {
+        move(Operand::MakeImm(0), dst);
+        return true;
+    }
+
+    // factor = scales * 2^shift, scales are 3, 5 or 9 and at most two of them
+    auto number = static_cast<uint32_t>(factor.value);
+    auto negative = (factor.value < 0);
+    if (negative) {
+        number = 0 - number;
+        if ((number & (number - 1)) != 0)
+            return false;
+    }
+
+    int shift = 0;
+    for (; number != 0 && (number & 1) == 0; number >>= 1)
+        shift++;
+    std::array<int, 2> scales{};
+    size_t count = 0;
+    for (auto scale : { 9, 5, 3 }) {
+        while (count < scales.size() && number != 1 && number % scale == 0) {
+            scales[count++] = scale - 1;
+            number /= scale;
+        }
+    }
+    if (number != 1 || count + (shift != 0) > 2)
+        return false;
+
+    auto result = (dst.kind == Operand::reg) ? dst : Operand::MakeReg(eax);
+    auto first = size_t{ 0 };
+    if (count > 0 && x.kind == Operand::reg) {
+        machine.Add(Opcode::lea, Operand::MakeScaled(x.r, x.r, scales[0]), result);
+        first = 1;
+    }
+    else
+        move(x, result);
+
+    for (auto i = first; i < count; i++)
+        machine.Add(Opcode::lea, Operand::MakeScaled(result.r, result.r, scales[i]), result);
+    if (shift == 1)
+        machine.Add(Opcode::add, result, result);
+    else if (shift > 1)
+        machine.Add(Opcode::shl, Operand::MakeImm(shift), result);
+    if (negative)
+        machine.Add(Opcode::neg, result);
+    move(result, dst);
+    return true;
+}
+
+
+/**
+ * @brief Lower division, it's truncated toward zero like 'div' of Pascal: the
+ *        dividend goes to %eax, %edx takes its sign by 'cltd' for 'idivl'.
+ *        A constant divisor takes no 'idivl'
+ * @param[in] t_value - division
+ *
+ * @return none
+ * @note Only 0 and -2^31 go to the slot of divisor, 'idivl' takes no
+ * immediate
+ */
+void SsaLowering::lowerDivision(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto dividend = getOperand(inst.a);
+    auto divisor = getOperand(inst.b);
+    auto dst = getOperand(t_value);
+    if (divisor.kind == Operand::imm) {
+        int result;
+        if (dividend.IsImm(dividend.value) && divisor.IsImm(divisor.value)
+            && SsaCode::Compute(SsaOp::div, dividend.value, divisor.value, result)) {
+            move(Operand::MakeImm(result), dst);
+            return;
+        }
+        if (dividend.kind != Operand::imm && divisor.IsImm(divisor.value)
+            && lowerConstantDivision(dividend, divisor.value, dst))
+            return;
+
+        auto slot = getDivisor();
+        machine.Add(Opcode::mov, divisor, slot);
+        divisor = slot;
+    }
+
+    move(dividend, Operand::MakeReg(eax));
+    machine.Add(Opcode::cltd);
+    machine.Add(Opcode::idiv, divisor);
+    move(Operand::MakeReg(eax), dst);
+}
+
+
+/**
+ * @brief Lower division by a constant: 1 and -1 are a copy and 'negl', a
+ *        power of two is an arithmetic shift of the dividend which is rounded
+ *        toward zero, other divisors are a multiplication by the magic number
+ * @param[in] t_x       - dividend in a register or memory, it isn't %edx
+ * @param[in] t_divisor - divisor
+ * @param[in] t_dst     - place of quotient
+ *
+ * @return false if the divisor is 0 or -2^31
+ * @note Hacker's Delight, 10-4: the high word of M * x shifted right by s is
+ * x / d rounded down, the sign bit of it makes it rounded toward zero. A
+ * negative divisor negates the quotient of its absolute value
+ */
+bool SsaLowering::lowerConstantDivision(const Operand& t_x, int t_divisor, const Operand& t_dst) {
+    if (t_divisor == 0 || t_divisor == INT32_MIN)
+        return false;
+
+    auto number = static_cast<uint32_t>((t_divisor < 0) ? -t_divisor : t_divisor);
+    auto eax_reg = Operand::MakeReg(eax);
+    auto edx_reg = Operand::MakeReg(edx);
+    if (number == 1) {
+        auto result = (t_dst.kind == Operand::reg) ? t_dst : eax_reg;
+        move(t_x, result);
+        if (t_divisor < 0)
+            machine.Add(Opcode::neg, result);
+        move(result, t_dst);
+        return true;
+    }
+
+    if ((number & (number - 1)) == 0) {
+        int shift = 0;
+        while ((1u << shift) != number)
+            shift++;
+        // a negative dividend is rounded up by divisor - 1 before the shift
+        move(t_x, eax_reg);
+        machine.Add(Opcode::cltd);
+        if (shift == 1)
+            machine.Add(Opcode::sub, edx_reg, eax_reg);
+        else {
+            machine.Add(Opcode::and_, Operand::MakeImm(static_cast<int>(number - 1)), edx_reg);
+            machine.Add(Opcode::add, edx_reg, eax_reg);
+        }
+        machine.Add(Opcode::sar, Operand::MakeImm(shift), eax_reg);
+        if (t_divisor < 0)
+            machine.Add(Opcode::neg, eax_reg);
+        move(eax_reg, t_dst);
+        return true;
+    }
+
+    int magic;
+    int shift;
+    getMagic(number, magic, shift);
+    machine.Add(Opcode::mov, Operand::MakeImm(magic), eax_reg);
+    machine.Add(Opcode::imul, t_x);
+    if (magic < 0)
+        machine.Add(Opcode::add, t_x, edx_reg);
+    if (shift > 0)
+        machine.Add(Opcode::sar, Operand::MakeImm(shift), edx_reg);
+    machine.Add(Opcode::mov, edx_reg, eax_reg);
+    machine.Add(Opcode::shr, Operand::MakeImm(31), eax_reg);
+    machine.Add(Opcode::add, eax_reg, edx_reg);
+    if (t_divisor < 0)
+        machine.Add(Opcode::neg, edx_reg);
+    move(edx_reg, t_dst);
+    return true;
+}
+
+
+/**
+ * @brief Find the magic number of signed division by a constant
+ * @param[in]  t_divisor - divisor from 3 to 2^31 - 1
+ * @param[out] t_magic   - multiplier M, its high word is taken
+ * @param[out] t_shift   - shift of the high word
+ *
+ * @return none
+ * @note Hacker's Delight, 10-1: the least 2^p which makes M = (2^p / d) + 1
+ * exact for all 32-bit dividends
+ */
+void SsaLowering::getMagic(uint32_t t_divisor, int& t_magic, int& t_shift) {
+    const uint32_t two31 = 0x80000000u;
+    auto anc = two31 - 1 - two31 % t_divisor;     // |nc|, the greatest dividend with remainder d - 1
+    auto p = 31;
+    auto q1 = two31 / anc;
+    auto r1 = two31 - q1 * anc;
+    auto q2 = two31 / t_divisor;
+    auto r2 = two31 - q2 * t_divisor;
+    uint32_t delta;
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= t_divisor) {
+            q2++;
+            r2 -= t_divisor;
+        }
+        delta = t_divisor - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    t_magic = static_cast<int>(q2 + 1);
+    t_shift = p - 32;
+}
+
+
+/**
+ * @brief Lower comparison: it's left in flags for the selects after it, else
+ *        'setcc' gives 0 or 1 in %al which is zero-extended
+ * @param[in] t_value - comparison
+ *
+ * @return none
+ */
+void SsaLowering::lowerCompare(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    compareValues(inst.a, inst.b, static_cast<OpKind>(inst.imm));
+    if (fused[t_value])
+        return;
+
+    auto eax_reg = Operand::MakeReg(eax);
+    auto dst = getOperand(t_value);
+    auto result = (dst.kind == Operand::reg) ? dst : eax_reg;
+    machine.Add(getSet(flags), eax_reg);
+    machine.Add(Opcode::movzb, eax_reg, result);
+    move(result, dst);
+}
+
+
+/**
+ * @brief Lower select by 'cmovcc': the value which isn't taken on the
+ *        condition is moved first. A comparison which isn't in flags is
+ *        tested against zero
+ * @param[in] t_value - select
+ *
+ * @return none
+ * @note 'cmovcc' takes no immediate and writes a register: an immediate goes
+ * to %eax or to memory of the value, memory is selected in %eax. Only moves
+ * are between the comparison and 'cmovcc', flags stay for the next select
+ */
+void SsaLowering::lowerSelect(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto taken = getOperand(inst.a);
+    auto other = getOperand(inst.b);
+    auto dst = getOperand(t_value);
+    auto cond = flags;
+    if (!fused[inst.c]) {
+        auto c = getOperand(inst.c);
+        if (c.IsImm(c.value)) {
+            move((c.value != 0) ? taken : other, dst);
+            return;
+        }
+        machine.Add(Opcode::cmp, Operand::MakeImm(0), c);
+        cond = OpKind::ne;
+    }
+
+    if (taken == other) {
+        move(taken, dst);
+        return;
+    }
+    if (dst == taken) {
+        std::swap(taken, other);
+        cond = negate(cond);
+    }
+
+    auto eax_reg = Operand::MakeReg(eax);
+    if (dst.kind == Operand::reg) {
+        if (taken.kind == Operand::imm) {
+            move(taken, eax_reg);
+            taken = eax_reg;
+        }
+        move(other, dst);
+        machine.Add(getMove(cond), taken, dst);
+        return;
+    }
+
+    move(other, eax_reg);
+    if (taken.kind == Operand::imm) {
+        move(taken, dst);
+        taken = dst;
+    }
+    machine.Add(getMove(cond), taken, eax_reg);
+    move(eax_reg, dst);
+}
+
+
+/**
+ * @brief Compare two values, an immediate goes first and the condition is
+ *        mirrored, two immediates or memory operands take %eax
+ * @param[in] t_lhs  - left operand
+ * @param[in] t_rhs  - right operand
+ * @param[in] t_cond - condition, it's kept for the jump or 'setcc'
+ *
+ * @return none
+ */
+void SsaLowering::compareValues(value_t t_lhs, value_t t_rhs, OpKind t_cond) {
+    auto lhs = getOperand(t_lhs);
+    auto rhs = getOperand(t_rhs);
+    flags = t_cond;
+
+    if (lhs.kind == Operand::imm && rhs.kind != Operand::imm) {
+        std::swap(lhs, rhs);
+        flags = mirror(flags);
+    }
+    if (lhs.kind == Operand::imm || (lhs.kind == Operand::mem && rhs.kind == Operand::mem)) {
+        move(lhs, Operand::MakeReg(eax));
+        lhs = Operand::MakeReg(eax);
+    }
+    machine.Add(Opcode::cmp, rhs, lhs);
+}
+
+
+/**
+ * @brief Lower conditional jump with copies of its edges. Copies of the edge
+ *        which jumps go before the jump if they don't break the other edge,
+ *        else to a block of edge. Copies of the edge to the next block go
+ *        after the jump
+ * @param[in] t_block - block with branch, the comparison is done
+ * @param[in] t_next  - next block of code
+ *
+ * @return none
+ */
+void SsaLowering::lowerBranch(block_t t_block, block_t t_next) {
+    auto& block = code->GetBlock(t_block);
+    auto to = block.succ[0];
+    auto other = block.succ[1];
+    auto cond = flags;
+    if (to == t_next) {
+        std::swap(to, other);
+        cond = negate(cond);
+    }
+
+    std::vector<Move> to_moves;
+    std::vector<Move> other_moves;
+    getMoves(t_block, to, to_moves);
+    getMoves(t_block, other, other_moves);
+
+    if (to_moves.empty() || isHoisted(to_moves, other, other_moves)) {
+        addMoves(to_moves);
+        jump(getJump(cond), getLabel(to));
+        addMoves(other_moves);
+        if (other != t_next)
+            jump(Opcode::jmp, getLabel(other));
+        return;
+    }
+
+    // the edge which jumps has copies: the other edge jumps instead if it can
+    if (other_moves.empty()) {
+        jump(getJump(negate(cond)), getLabel(other));
+        addMoves(to_moves);
+        jump(Opcode::jmp, getLabel(to));
+        return;
+    }
+
+    auto edge = newLabel();
+    jump(getJump(cond), edge);
+    addMoves(other_moves);
+    jump(Opcode::jmp, getLabel(other));
+    machine.AddLabel(edge);
+    addMoves(to_moves);
+    jump(Opcode::jmp, getLabel(to));
+}
+
+
+/**
+ * @brief Check that copies of edge can be done before the jump: they don't
+ *        write a value which is live into the other successor or is copied
+ *        on the other edge
+ * @param[in] t_moves       - copies of edge
+ * @param[in] t_other       - successor of the other edge
+ * @param[in] t_other_moves - copies of the other edge
+ *
+ * @return true if copies go before the jump
+ */
+bool SsaLowering::isHoisted(const std::vector<Move>& t_moves, block_t t_other,
+                            const std::vector<Move>& t_other_moves) const {
+    auto start = alloc.GetStart(t_other);
+    for (auto& move : t_moves) {
+        if (alloc.IsTaken(alloc.GetLocation(move.phi), start))
+            return false;
+
+        for (auto& other : t_other_moves) {
+            if (other.src == move.dst)
+                return false;
+        }
+    }
+    return true;
+}
+
+
+// copies of edge into phis of successor
+void SsaLowering::getMoves(block_t t_from, block_t t_to, std::vector<Move>& t_moves) {
+    auto& block = code->GetBlock(t_to);
+    auto idx = std::find(block.preds.begin(), block.preds.end(), t_from) - block.preds.begin();
+    for (auto value : block.code) {
+        if (code->GetInst(value).op != SsaOp::phi)
+            break;
+
+        auto src = getOperand(code->GetArgs(value)[idx]);
+        auto dst = getOperand(value);
+        if (src != dst)
+            t_moves.push_back({ src, dst, value });
+    }
+}
+
+
+/**
+ * @brief Do copies which are parallel by moves: a copy goes when its place
+ *        isn't read by the others, a cycle is broken by exchange
+ * @param[in,out] t_moves - copies with different places, they are consumed
+ *
+ * @return none
+ */
+void SsaLowering::addMoves(std::vector<Move>& t_moves) {
+    while (!t_moves.empty()) {
+        auto ready = std::find_if(t_moves.begin(), t_moves.end(), [&](const Move& t_move) {
+            return std::none_of(t_moves.begin(), t_moves.end(),
+                [&](const Move& t_other) { return t_other.src == t_move.dst; });
+        });
+        if (ready != t_moves.end()) {
+            move(ready->src, ready->dst);
+            t_moves.erase(ready);
+            continue;
+        }
+
+        // every place is read: the first copy is done, the old value of its
+        // place is read from its source after the exchange
+        auto cycle = t_moves.front();
+        exchange(cycle.src, cycle.dst);
+        t_moves.erase(t_moves.begin());
+        for (auto& other : t_moves) {
+            if (other.src == cycle.dst)
+                other.src = cycle.src;
+        }
+        t_moves.erase(std::remove_if(t_moves.begin(), t_moves.end(),
+            [](const Move& t_move) { return t_move.src == t_move.dst; }), t_moves.end());
+    }
+}
+
+
+// indexed memory of x86-64 is an address by %r11
+void SsaLowering::move(const Operand& t_src, const Operand& t_dst) {
+    if (t_src == t_dst)
+        return;
+
+    auto is_memory = [](const Operand& t_op) { return t_op.kind == Operand::mem || t_op.kind == Operand::address; };
+    if (is_memory(t_src) && is_memory(t_dst)) {
+        machine.Add(Opcode::mov, t_src, Operand::MakeReg(eax));
+        machine.Add(Opcode::mov, Operand::MakeReg(eax), t_dst);
+        return;
+    }
+    machine.Add(Opcode::mov, t_src, t_dst);
+}
+
+
+void SsaLowering::exchange(const Operand& t_a, const Operand& t_b) {
+    if (t_a.kind == Operand::reg || t_b.kind == Operand::reg) {
+        machine.Add(Opcode::xchg, t_a, t_b);
+        return;
+    }
+
+    machine.Add(Opcode::mov, t_a, Operand::MakeReg(eax));
+    machine.Add(Opcode::xchg, Operand::MakeReg(eax), t_b);
+    machine.Add(Opcode::mov, Operand::MakeReg(eax), t_a);
+}
+
+
+SsaLowering::Operand SsaLowering::getOperand(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    auto location = alloc.GetLocation(t_value);
+    switch (location.kind) {
+    case RegAlloc::Location::reg:
+        return Operand::MakeReg(static_cast<Reg>(location.n));
+    case RegAlloc::Location::slot:
+        return Operand::MakeMem(slot_names[location.n]);
+    case RegAlloc::Location::memory:
+        return getMemory(inst);
+    case RegAlloc::Location::imm:
+        if (inst.op == SsaOp::address)
+            return Operand::MakeName(getName(inst.sym));
+        return Operand::MakeImm(inst.imm);
+    default:
+        throw std::runtime_error("<E> SsaLowering: value without location");
+    }
+}
+
+
+/**
+ * @brief Get memory of load or store, an index which isn't an immediate is
+ *        scaled by the size of element
+ * @param[in] t_inst  - load or store
+ * @param[in] t_index - register of index which is in memory on x86
+ *
+ * @return memory operand
+ * @note x86-64 addresses data by %rip which takes no index: the base of array
+ * goes to %r11, an index in memory goes there too and %rax adds the base
+ */
+SsaLowering::Operand SsaLowering::getMemory(const SsaCode::Inst& t_inst, Reg t_index) {
+    auto name = getName(t_inst.sym);
+    if (t_inst.b == SsaCode::NO_VALUE)
+        return Operand::MakeMem(name, t_inst.imm);
+
+    auto index = getOperand(t_inst.b);
+    if (index.kind == Operand::imm)
+        return Operand::MakeMem(name, t_inst.imm + t_inst.size * index.value);
+    if (!target.IsWide()) {
+        if (index.kind != Operand::reg) {
+            machine.Add(Opcode::mov, index, Operand::MakeReg(t_index));
+            index = Operand::MakeReg(t_index);
+        }
+        return Operand::MakeIndexed(name, t_inst.imm, index.r, t_inst.size);
+    }
+
+    auto base = Operand::MakeReg(r11d);
+    if (index.kind == Operand::reg) {
+        machine.Add(Opcode::lea, Operand::MakeMem(name), base, true);
+        return Operand::MakeScaled(r11d, index.r, t_inst.size, t_inst.imm);
+    }
+    machine.Add(Opcode::mov, index, base);
+    machine.Add(Opcode::lea, Operand::MakeMem(name), Operand::MakeReg(eax), true);
+    machine.Add(Opcode::lea, Operand::MakeScaled(eax, r11d, t_inst.size), base, true);
+    return Operand::MakeAddress(r11d, t_inst.imm);
+}
+
+
+SsaLowering::Operand SsaLowering::getLabel(block_t t_block) const {
+    auto& block = code->GetBlock(t_block);
+    return Operand::MakeLabel(block.kind, block.num);
+}
+
+
+/**
+ * @brief Get name of symbol in the code, it's added once
+ * @param[in] t_sym - symbol of variable, its label is its name
+ *
+ * @return index of name in the code
+ */
+MachineCode::name_t SsaLowering::getName(symbol_t t_sym) {
+    if (names[t_sym] == 0)
+        names[t_sym] = machine.AddName(Interner::Get().GetName(t_sym));
+    return names[t_sym];
+}
+
+
+Opcode SsaLowering::getJump(OpKind t_cond) {
+    switch (t_cond) {
+    case OpKind::eq: return Opcode::je;
+    case OpKind::ne: return Opcode::jne;
+    case OpKind::gt: return Opcode::jg;
+    case OpKind::lt: return Opcode::jl;
+    case OpKind::ge: return Opcode::jge;
+    case OpKind::le: return Opcode::jle;
+    default:         return Opcode::jmp;
+    }
+}
+
+
+// 'setcc' and 'cmovcc' go in order of conditional jumps
+Opcode SsaLowering::getSet(OpKind t_cond) {
+    return static_cast<Opcode>(static_cast<int>(Opcode::sete) + static_cast<int>(getJump(t_cond)) -
+        static_cast<int>(Opcode::je));
+}
+
+
+Opcode SsaLowering::getMove(OpKind t_cond) {
+    return static_cast<Opcode>(static_cast<int>(Opcode::cmove) + static_cast<int>(getJump(t_cond)) -
+        static_cast<int>(Opcode::je));
+}
+
+
+OpKind SsaLowering::negate(OpKind t_cond) {
+    switch (t_cond) {
+    case OpKind::eq: return OpKind::ne;
+    case OpKind::ne: return OpKind::eq;
+    case OpKind::gt: return OpKind::le;
+    case OpKind::lt: return OpKind::ge;
+    case OpKind::ge: return OpKind::lt;
+    case OpKind::le: return OpKind::gt;
+    default:         return t_cond;
+    }
+}
+
+
+// condition with swapped operands
+OpKind SsaLowering::mirror(OpKind t_cond) {
+    switch (t_cond) {
+    case OpKind::gt: return OpKind::lt;
+    case OpKind::lt: return OpKind::gt;
+    case OpKind::ge: return OpKind::le;
+    case OpKind::le: return OpKind::ge;
+    default:         return t_cond;
+    }
+}
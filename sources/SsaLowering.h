@@ -0,0 +1,116 @@
+#ifndef SSALOWERING_H
+#define SSALOWERING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MachineCode.h"
+#include "RegAlloc.h"
+#include "SsaCode.h"
+#include "Target.h"
+
+/*
+ * Lowering of SsaCode to MachineCode after register allocation. Blocks keep
+ * their order, a block gets a label if something may jump to it and falls
+ * through to the next one. Phis are copies on the edges: at the end of the
+ * predecessor, before its conditional jump if they don't break the other
+ * successor, else in a block of the edge after the jump.
+ *
+ * The comparison of a branch goes right after its operands are computed, the
+ * rest of block is done by moves and 'lea' which keep flags: the step of for
+ * loop is between 'cmpl' and 'jl'. Spilled values live in slots of '.bss'
+ * which GenCode adds after the code.
+ *
+ * A comparison which only selects right after it read stays in flags, the
+ * selects are 'cmovcc'. Other comparisons are values by 'setcc', a select of
+ * such value tests it. Booleans are bytes of memory, they go through %al.
+ *
+ * An element of array by index is 'name+offset(, index, size)' on x86 and
+ * 'offset(%r11, index, size)' after 'leaq name(%rip), %r11' on x86-64. A check
+ * of index jumps to 'ud2' after the code.
+ */
+class SsaLowering
+{
+public:
+	SsaLowering(const Target& t_target, MachineCode& t_machine) : target(t_target), machine(t_machine), alloc(t_target) {};
+
+	void				Lower(const SsaCode& t_code);
+
+	size_t				GetSlotCount() const { return slots.size(); }
+	const std::string&	GetSlot(size_t t_slot) const { return slots[t_slot]; }
+	size_t				GetSpilled() const { return alloc.GetSpilled(); }
+
+private:
+	using value_t = SsaCode::value_t;
+	using block_t = SsaCode::block_t;
+	using Operand = MachineCode::Operand;
+
+	struct Move {
+		Operand		src;
+		Operand		dst;
+		value_t		phi;
+	};
+
+	static constexpr uint32_t NO_COMPARE = UINT32_MAX;
+	static constexpr const char* TRAP_NAME = "_bounds_";
+
+	const Target&					target;
+	MachineCode&					machine;
+	RegAlloc						alloc;
+	const SsaCode*					code{ nullptr };
+	std::vector<uint32_t>			compare;		// block -> instructions before its comparison
+	std::vector<bool>				fused;			// value -> comparison which is left in flags
+	std::vector<bool>				labeled;		// block may be jumped to
+	std::vector<MachineCode::name_t>	names;		// symbol -> name in the code, 0 - not added
+	std::vector<std::string>		slots;			// names of spill slots, the divisor is the last
+	std::vector<MachineCode::name_t>	slot_names;
+	bool							divisor_used{ false };
+	size_t							extra_labels{ 0 };	// labels of edges and of the end
+	OpKind							flags{ OpKind::none };	// condition of the last comparison
+	Operand							trap{};			// label of 'ud2', none if no check is lowered
+
+	void		findCompares();
+	void		findFused();
+	void		findLabels();
+	void		addSlots();
+	void		lowerBlock(block_t t_block, block_t t_next);
+	void		lowerInst(value_t t_value, bool t_keep_flags);
+	void		lowerBinary(value_t t_value);
+	void		lowerStep(value_t t_value);
+	bool		lowerMultiply(value_t t_value);
+	void		lowerDivision(value_t t_value);
+	bool		lowerConstantDivision(const Operand& t_x, int t_divisor, const Operand& t_dst);
+	void		lowerCompare(value_t t_value);
+	void		lowerSelect(value_t t_value);
+	void		lowerLoad(value_t t_value);
+	void		lowerStore(value_t t_value);
+	void		lowerCheck(value_t t_value);
+	void		compareValues(value_t t_lhs, value_t t_rhs, OpKind t_cond);
+	void		lowerBranch(block_t t_block, block_t t_next);
+
+	void		getMoves(block_t t_from, block_t t_to, std::vector<Move>& t_moves);
+	bool		isHoisted(const std::vector<Move>& t_moves, block_t t_other,
+					const std::vector<Move>& t_other_moves) const;
+	void		addMoves(std::vector<Move>& t_moves);
+	void		move(const Operand& t_src, const Operand& t_dst);
+	void		exchange(const Operand& t_a, const Operand& t_b);
+	void		jump(Opcode t_op, const Operand& t_label) { machine.Add(t_op, t_label); }
+
+	Operand		getOperand(value_t t_value);
+	Operand		getMemory(const SsaCode::Inst& t_inst, Reg t_index = eax);
+	Operand		getLabel(block_t t_block) const;
+	Operand		newLabel() { return Operand::MakeLabel(LabelKind::block, code->GetBlockCount() + extra_labels++); }
+	Operand		getDivisor();
+	MachineCode::name_t	getName(symbol_t t_sym);
+
+	static bool		isStep(const SsaCode& t_code, value_t t_value);
+	static Opcode	getJump(OpKind t_cond);
+	static Opcode	getSet(OpKind t_cond);
+	static Opcode	getMove(OpKind t_cond);
+	static OpKind	negate(OpKind t_cond);
+	static OpKind	mirror(OpKind t_cond);
+	static void		getMagic(uint32_t t_divisor, int& t_magic, int& t_shift);
+};
+
+#endif // !SSALOWERING_H
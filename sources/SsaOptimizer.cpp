@@ -0,0 +1,1117 @@
+#include "SsaOptimizer.h"
+#include <algorithm>
+#include <climits>
+
+using value_t = SsaCode::value_t;
+using block_t = SsaCode::block_t;
+
+
+/**
+ * @brief Run passes by the level of optimization
+ * @param[inout] t_code - code of program
+ *
+ * @return number of values removed by copy propagation and dead code elimination
+ */
+size_t SsaOptimizer::Run(SsaCode& t_code) {
+    if (level <= 0)
+        return 0;
+
+    code = &t_code;
+    while (rounds < MAX_ROUNDS) {
+        rounds++;
+        auto changed = propagateConstants();
+        code->Compact();
+        changed |= propagateCopies();
+        changed |= eliminateDeadCode();
+        code->Compact();
+        if (selectBranches()) {
+            propagateCopies();
+            code->Compact();
+            changed = true;
+        }
+
+        if (level < 2 || !changed)
+            break;
+    }
+    if (removeChecks()) {
+        propagateCopies();
+        code->Compact();
+    }
+    hoistInvariants();
+    return copies + dead_values;
+}
+
+
+/**
+ * @brief Sparse conditional constant propagation: values are constants until
+ *        an operand says else, only edges which can run are followed
+ * @param none
+ *
+ * @return true if code is changed
+ * @note Wegman and Zadeck: a value is lowered at most twice on the lattice,
+ * so every instruction is visited a few times
+ */
+bool SsaOptimizer::propagateConstants() {
+    auto& order = code->GetOrder();
+    if (order.empty())
+        return false;
+
+    states.assign(code->GetValueCount(), top);
+    numbers.assign(code->GetValueCount(), 0);
+    reached.assign(code->GetBlockCount(), false);
+    edge_first.assign(code->GetBlockCount() + 1, 0);
+    for (auto b : order)
+        edge_first[b + 1] = static_cast<uint32_t>(code->GetBlock(b).preds.size());
+    for (size_t b = 0; b < code->GetBlockCount(); b++)
+        edge_first[b + 1] += edge_first[b];
+    edges_run.assign(edge_first.back(), false);
+    findUsers();
+
+    flow_list.clear();
+    value_list.clear();
+    flow_list.emplace_back(SsaCode::NO_BLOCK, order.front());
+    while (!flow_list.empty() || !value_list.empty()) {
+        while (!flow_list.empty()) {
+            auto [from, to] = flow_list.back();
+            flow_list.pop_back();
+            runEdge(from, to);
+        }
+        while (!value_list.empty()) {
+            auto value = value_list.back();
+            value_list.pop_back();
+            for (auto i = user_first[value]; i < user_first[value + 1]; i++) {
+                if (reached[code->GetInst(users[i]).block])
+                    visit(users[i]);
+            }
+            for (auto i = branch_first[value]; i < branch_first[value + 1]; i++)
+                visitExit(branch_users[i]);
+        }
+    }
+
+    auto before = folded + branches + dead_blocks;
+    rewriteConstants();
+    return folded + branches + dead_blocks != before;
+}
+
+
+// users of every value in arrays of CSR: counted, then placed
+void SsaOptimizer::findUsers() {
+    auto count = code->GetValueCount();
+    auto each = [this](auto t_fn) {
+        for (auto b : code->GetOrder()) {
+            for (auto value : code->GetBlock(b).code) {
+                auto& inst = code->GetInst(value);
+                if (inst.op == SsaOp::phi) {
+                    for (auto arg : code->GetArgs(value))
+                        t_fn(arg, value);
+                }
+                else
+                    code->ForOperands(inst, [&](value_t t_arg) { t_fn(t_arg, value); });
+            }
+        }
+    };
+    auto each_branch = [this](auto t_fn) {
+        for (auto b : code->GetOrder()) {
+            auto& block = code->GetBlock(b);
+            if (block.exit == SsaExit::branch) {
+                t_fn(block.lhs, b);
+                t_fn(block.rhs, b);
+            }
+        }
+    };
+
+    user_first.assign(count + 1, 0);
+    each([this](value_t t_used, value_t) { user_first[t_used + 1]++; });
+    for (size_t i = 0; i < count; i++)
+        user_first[i + 1] += user_first[i];
+    users.resize(user_first.back());
+    auto next = user_first;
+    each([&](value_t t_used, value_t t_user) { users[next[t_used]++] = t_user; });
+
+    branch_first.assign(count + 1, 0);
+    each_branch([this](value_t t_used, block_t) { branch_first[t_used + 1]++; });
+    for (size_t i = 0; i < count; i++)
+        branch_first[i + 1] += branch_first[i];
+    branch_users.resize(branch_first.back());
+    next = branch_first;
+    each_branch([&](value_t t_used, block_t t_block) { branch_users[next[t_used]++] = t_block; });
+}
+
+
+/**
+ * @brief Mark edge which runs, a block is visited when its first edge runs,
+ *        later edges change only its phis
+ * @param[in] t_from - predecessor, NO_BLOCK for the entry
+ * @param[in] t_to   - block
+ *
+ * @return none
+ */
+void SsaOptimizer::runEdge(block_t t_from, block_t t_to) {
+    auto& block = code->GetBlock(t_to);
+    if (t_from != SsaCode::NO_BLOCK) {
+        for (size_t i = 0; i < block.preds.size(); i++) {
+            if (block.preds[i] != t_from)
+                continue;
+            if (edges_run[edge_first[t_to] + i])
+                return;
+            edges_run[edge_first[t_to] + i] = true;
+            break;
+        }
+    }
+
+    if (reached[t_to]) {
+        for (auto value : block.code) {
+            if (code->GetInst(value).op != SsaOp::phi)
+                break;
+            visit(value);
+        }
+        return;
+    }
+
+    reached[t_to] = true;
+    for (auto value : block.code)
+        visit(value);
+    visitExit(t_to);
+}
+
+
+void SsaOptimizer::visit(value_t t_value) {
+    auto& inst = code->GetInst(t_value);
+    switch (inst.op) {
+    case SsaOp::constant:
+        lower(t_value, constant, inst.imm);
+        return;
+    case SsaOp::address:
+    case SsaOp::load:
+        lower(t_value, bottom, 0);
+        return;
+    case SsaOp::store:
+    case SsaOp::nop:
+        return;
+    case SsaOp::copy:
+        lower(t_value, states[inst.a], numbers[inst.a]);
+        return;
+    case SsaOp::check: {
+        // an index out of range traps, it isn't a value
+        auto a = states[inst.a];
+        if (a == constant && numbers[inst.a] >= inst.imm && numbers[inst.a] <= code->GetInst(inst.b).imm)
+            lower(t_value, constant, numbers[inst.a]);
+        else if (a != top)
+            lower(t_value, bottom, 0);
+        return;
+    }
+    case SsaOp::compare: {
+        auto a = states[inst.a];
+        auto b = states[inst.b];
+        if (a == bottom || b == bottom)
+            lower(t_value, bottom, 0);
+        else if (a == constant && b == constant)
+            lower(t_value, constant, SsaCode::Compare(static_cast<OpKind>(inst.imm), numbers[inst.a], numbers[inst.b]));
+        return;
+    }
+    case SsaOp::select: {
+        // the operand which is taken, else both of them like a phi
+        auto c = states[inst.c];
+        if (c == constant) {
+            auto arg = (numbers[inst.c] != 0) ? inst.a : inst.b;
+            lower(t_value, states[arg], numbers[arg]);
+            return;
+        }
+        if (c == top)
+            return;
+        auto a = states[inst.a];
+        auto b = states[inst.b];
+        if (a == bottom || b == bottom || (a == constant && b == constant && numbers[inst.a] != numbers[inst.b]))
+            lower(t_value, bottom, 0);
+        else if (a == constant || b == constant)
+            lower(t_value, constant, (a == constant) ? numbers[inst.a] : numbers[inst.b]);
+        return;
+    }
+    case SsaOp::phi: {
+        // arguments of edges which don't run are ignored
+        auto& args = code->GetArgs(t_value);
+        auto first = edge_first[inst.block];
+        auto state = top;
+        auto number = 0;
+        for (size_t i = 0; i < args.size() && state != bottom; i++) {
+            auto arg = args[i];
+            if (!edges_run[first + i] || states[arg] == top)
+                continue;
+            if (states[arg] == bottom || (state == constant && numbers[arg] != number))
+                state = bottom;
+            else {
+                state = constant;
+                number = numbers[arg];
+            }
+        }
+        lower(t_value, state, number);
+        return;
+    }
+    default:
+        break;
+    }
+
+    auto a = states[inst.a];
+    auto b = states[inst.b];
+    // x * 0 and x and 0 are zero for any x
+    if ((inst.op == SsaOp::mul || inst.op == SsaOp::and_) &&
+        ((a == constant && numbers[inst.a] == 0) || (b == constant && numbers[inst.b] == 0))) {
+        lower(t_value, constant, 0);
+        return;
+    }
+
+    if (a == bottom || b == bottom)
+        lower(t_value, bottom, 0);
+    else if (a == constant && b == constant) {
+        int number;
+        if (SsaCode::Compute(inst.op, numbers[inst.a], numbers[inst.b], number))
+            lower(t_value, constant, number);
+        else
+            lower(t_value, bottom, 0);
+    }
+}
+
+
+// edges of block exit which can run by the known operands of branch
+void SsaOptimizer::visitExit(block_t t_block) {
+    if (!reached[t_block])
+        return;
+
+    auto& block = code->GetBlock(t_block);
+    switch (block.exit) {
+    case SsaExit::jump:
+        flow_list.emplace_back(t_block, block.succ[0]);
+        break;
+    case SsaExit::branch: {
+        auto lhs = states[block.lhs];
+        auto rhs = states[block.rhs];
+        if (lhs == constant && rhs == constant) {
+            auto taken = SsaCode::Compare(block.cond, numbers[block.lhs], numbers[block.rhs]);
+            flow_list.emplace_back(t_block, block.succ[taken ? 0 : 1]);
+        }
+        else if (lhs == bottom || rhs == bottom) {
+            flow_list.emplace_back(t_block, block.succ[0]);
+            flow_list.emplace_back(t_block, block.succ[1]);
+        }
+        break;
+    }
+    case SsaExit::ret:
+        break;
+    }
+}
+
+
+// value only goes down the lattice, its users are visited again
+void SsaOptimizer::lower(value_t t_value, State t_state, int t_number) {
+    auto& state = states[t_value];
+    if (t_state == top || t_state < state)
+        return;
+    if (t_state == state && (state == bottom || numbers[t_value] == t_number))
+        return;
+
+    state = (t_state == state) ? bottom : t_state; // other constant on the second visit
+    numbers[t_value] = t_number;
+    value_list.push_back(t_value);
+}
+
+
+/**
+ * @brief Replace constant values by constants, branches on constants by jumps
+ *        and remove blocks which aren't reached, a constant index of array
+ *        goes to the offset of load or store
+ * @param none
+ *
+ * @return none
+ */
+void SsaOptimizer::rewriteConstants() {
+    for (auto b : code->GetOrder()) {
+        if (reached[b])
+            continue;
+
+        auto& block = code->GetBlock(b);
+        for (auto succ : block.succ) {
+            if (succ != SsaCode::NO_BLOCK)
+                code->RemoveEdge(b, succ);
+        }
+        for (auto value : block.code)
+            code->Remove(value);
+        block.removed = true;
+        dead_blocks++;
+    }
+
+    for (auto b : code->GetOrder()) {
+        if (!reached[b])
+            continue;
+
+        auto& block = code->GetBlock(b);
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::select && states[value] != constant && states[inst.c] == constant) {
+                inst = { SsaOp::copy, b, (numbers[inst.c] != 0) ? inst.a : inst.b, SsaCode::NO_VALUE, 0, NO_SYMBOL };
+                folded++;
+                continue;
+            }
+            if ((inst.op == SsaOp::load || inst.op == SsaOp::store) && inst.b != SsaCode::NO_VALUE &&
+                states[inst.b] == constant) {
+                inst.imm += inst.size * numbers[inst.b];
+                inst.b = SsaCode::NO_VALUE;
+                folded++;
+                continue;
+            }
+            if (states[value] != constant || inst.op == SsaOp::constant)
+                continue;
+
+            code->Remove(value);
+            inst = { SsaOp::constant, b, SsaCode::NO_VALUE, SsaCode::NO_VALUE, numbers[value], NO_SYMBOL };
+            folded++;
+        }
+
+        if (block.exit != SsaExit::branch || states[block.lhs] != constant || states[block.rhs] != constant)
+            continue;
+
+        auto taken = SsaCode::Compare(block.cond, numbers[block.lhs], numbers[block.rhs]) ? 0 : 1;
+        auto to = block.succ[taken];
+        if (block.succ[1 - taken] != to)
+            code->RemoveEdge(b, block.succ[1 - taken]);
+        block.exit = SsaExit::jump;
+        block.succ = { to, SsaCode::NO_BLOCK };
+        block.lhs = SsaCode::NO_VALUE;
+        block.rhs = SsaCode::NO_VALUE;
+        branches++;
+    }
+}
+
+
+/**
+ * @brief Replace copies and phis of one value by the value
+ * @param none
+ *
+ * @return true if code is changed
+ * @note A phi of the head of loop which gets itself from the back edge is a
+ * phi of one value too. Phis are looked at again while some of them become
+ * copies
+ */
+bool SsaOptimizer::propagateCopies() {
+    std::vector<value_t> by(code->GetValueCount(), SsaCode::NO_VALUE);
+    auto find = [&by](value_t t_value) {
+        while (by[t_value] != SsaCode::NO_VALUE)
+            t_value = by[t_value];
+        return t_value;
+    };
+
+    size_t found = 0;
+    for (auto b : code->GetOrder()) {
+        for (auto value : code->GetBlock(b).code) {
+            if (code->GetInst(value).op == SsaOp::copy) {
+                by[value] = code->GetInst(value).a;
+                found++;
+            }
+        }
+    }
+
+    for (auto again = true; again; ) {
+        again = false;
+        for (auto b : code->GetOrder()) {
+            for (auto value : code->GetBlock(b).code) {
+                if (code->GetInst(value).op != SsaOp::phi)
+                    break;
+                if (by[value] != SsaCode::NO_VALUE)
+                    continue;
+
+                auto same = SsaCode::NO_VALUE;
+                auto single = true;
+                for (auto arg : code->GetArgs(value)) {
+                    arg = find(arg);
+                    if (arg == value || arg == same)
+                        continue;
+                    if (same != SsaCode::NO_VALUE) {
+                        single = false;
+                        break;
+                    }
+                    same = arg;
+                }
+                if (single && same != SsaCode::NO_VALUE) {
+                    by[value] = same;
+                    found++;
+                    again = true;
+                }
+            }
+        }
+    }
+    if (found == 0)
+        return false;
+
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (by[value] != SsaCode::NO_VALUE) {
+                code->Remove(value);
+                continue;
+            }
+            if (inst.op == SsaOp::phi) {
+                for (auto& arg : code->GetArgs(value))
+                    arg = find(arg);
+            }
+            if (inst.a != SsaCode::NO_VALUE)
+                inst.a = find(inst.a);
+            if (inst.b != SsaCode::NO_VALUE)
+                inst.b = find(inst.b);
+            if (inst.c != SsaCode::NO_VALUE)
+                inst.c = find(inst.c);
+        }
+        if (block.exit == SsaExit::branch) {
+            block.lhs = find(block.lhs);
+            block.rhs = find(block.rhs);
+        }
+    }
+    copies += found;
+    return true;
+}
+
+
+/**
+ * @brief Remove values which are not needed: stores, branches, checks and
+ *        division which may fault need their operands, other values are
+ *        needed if a needed value uses them
+ * @param none
+ *
+ * @return true if code is changed
+ */
+bool SsaOptimizer::eliminateDeadCode() {
+    std::vector<bool> live(code->GetValueCount(), false);
+    std::vector<value_t> work;
+    auto mark = [&](value_t t_value) {
+        if (!live[t_value]) {
+            live[t_value] = true;
+            work.push_back(t_value);
+        }
+    };
+
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        for (auto value : block.code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::store || inst.op == SsaOp::check)
+                mark(value);
+            else if (inst.op == SsaOp::div) {
+                auto& divisor = code->GetInst(inst.b);
+                if (divisor.op != SsaOp::constant || divisor.imm == 0)
+                    mark(value);
+            }
+        }
+        if (block.exit == SsaExit::branch) {
+            mark(block.lhs);
+            mark(block.rhs);
+        }
+    }
+
+    while (!work.empty()) {
+        auto value = work.back();
+        work.pop_back();
+        auto& inst = code->GetInst(value);
+        if (inst.op == SsaOp::phi) {
+            for (auto arg : code->GetArgs(value))
+                mark(arg);
+        }
+        else
+            code->ForOperands(inst, mark);
+    }
+
+    auto before = dead_values;
+    for (auto b : code->GetOrder()) {
+        for (auto value : code->GetBlock(b).code) {
+            if (!live[value] && code->GetInst(value).op != SsaOp::nop) {
+                code->Remove(value);
+                dead_values++;
+            }
+        }
+    }
+    return dead_values != before;
+}
+
+
+/**
+ * @brief If-conversion: a branch to a block and the join after it or to two
+ *        blocks which jump to one join becomes a jump, the blocks go to the
+ *        end of the branch and phis of the join become selects
+ * @param none
+ *
+ * @return true if code is changed
+ * @note Code is compacted, phis go first. A phi takes its argument of the
+ * 'then' edge if the comparison of branch is true. The removed blocks are
+ * left for Compact()
+ */
+bool SsaOptimizer::selectBranches() {
+    auto before = selects;
+    for (auto b : code->GetOrder()) {
+        auto& block = code->GetBlock(b);
+        if (block.removed || block.exit != SsaExit::branch || block.succ[0] == block.succ[1])
+            continue;
+
+        auto then = block.succ[0];
+        auto other = block.succ[1];
+        auto then_arm = isArm(then, b);
+        auto other_arm = isArm(other, b);
+        auto join = then_arm ? code->GetBlock(then).succ[0] : other;
+        if (other_arm && !then_arm)
+            join = code->GetBlock(other).succ[0];
+        if ((!then_arm && !other_arm) || (then_arm && other_arm && code->GetBlock(other).succ[0] != join) ||
+            (!then_arm && then != join) || (!other_arm && other != join) || join == b)
+            continue;
+
+        auto& join_block = code->GetBlock(join);
+        auto then_pred = then_arm ? then : b;
+        auto other_pred = other_arm ? other : b;
+        if (join_block.preds.size() != 2)
+            continue;
+        size_t phis = 0;
+        for (auto value : join_block.code)
+            phis += (code->GetInst(value).op == SsaOp::phi);
+        if (phis > MAX_SELECTS)
+            continue;
+
+        for (auto arm : { then, other }) {
+            if (arm == join)
+                continue;
+            auto& arm_block = code->GetBlock(arm);
+            for (auto value : arm_block.code) {
+                code->GetInst(value).block = b;
+                block.code.push_back(value);
+            }
+            arm_block.code.clear();
+            arm_block.removed = true;
+        }
+
+        auto then_index = (join_block.preds[0] == then_pred) ? 0 : 1;
+        auto cond = SsaCode::NO_VALUE;
+        for (auto value : join_block.code) {
+            if (code->GetInst(value).op != SsaOp::phi)
+                break;
+            if (cond == SsaCode::NO_VALUE)
+                cond = code->Add(b, SsaOp::compare, block.lhs, block.rhs, static_cast<int>(block.cond));
+            auto& args = code->GetArgs(value);
+            auto select = code->AddSelect(b, cond, args[then_index], args[1 - then_index]);
+            code->Remove(value);
+            code->GetInst(value) = { SsaOp::copy, join, select, SsaCode::NO_VALUE, 0, NO_SYMBOL };
+        }
+
+        for (auto pred : { then_pred, other_pred })
+            code->RemoveEdge(pred, join);
+        block.lhs = SsaCode::NO_VALUE;
+        block.rhs = SsaCode::NO_VALUE;
+        block.cond = OpKind::none;
+        code->SetJump(b, join);
+        selects++;
+    }
+    return selects != before;
+}
+
+
+// block is reached by the branch only, jumps and has few values which can't fault
+bool SsaOptimizer::isArm(block_t t_block, block_t t_branch) const {
+    auto& block = code->GetBlock(t_block);
+    if (block.preds.size() != 1 || block.preds[0] != t_branch || block.exit != SsaExit::jump ||
+        block.code.size() > MAX_ARM)
+        return false;
+
+    return std::none_of(block.code.begin(), block.code.end(), [this](value_t t_value) {
+        auto& inst = code->GetInst(t_value);
+        return inst.op == SsaOp::store || inst.op == SsaOp::div || inst.op == SsaOp::phi ||
+            inst.op == SsaOp::check || (inst.op == SsaOp::load && inst.b != SsaCode::NO_VALUE);
+    });
+}
+
+
+/**
+ * @brief Remove checks of index which can't trap: ranges of values are found
+ *        in order of code, a check of the value which is in range of array or
+ *        which is checked before in its block becomes a copy
+ * @param none
+ *
+ * @return true if code is changed
+ * @note A phi gets a range if its arguments are found before it or it's the
+ * variable of for loop: the head gets the first value or the step of the
+ * latch, which branches back only if the variable didn't reach the bound
+ */
+bool SsaOptimizer::removeChecks() {
+    auto& order = code->GetOrder();
+    auto has_checks = std::any_of(order.begin(), order.end(), [this](block_t t_block) {
+        auto& list = code->GetBlock(t_block).code;
+        return std::any_of(list.begin(), list.end(),
+            [this](value_t t_value) { return code->GetInst(t_value).op == SsaOp::check; });
+    });
+    if (!has_checks)
+        return false;
+
+    places.assign(code->GetBlockCount(), 0);
+    for (size_t i = 0; i < order.size(); i++)
+        places[order[i]] = static_cast<uint32_t>(i);
+    ranges.assign(code->GetValueCount(), FULL_RANGE);
+    ranged.assign(code->GetValueCount(), false);
+
+    auto before = checks;
+    std::vector<value_t> block_checks;
+    for (auto b : order) {
+        block_checks.clear();
+        for (auto value : code->GetBlock(b).code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::check) {
+                auto high = code->GetInst(inst.b).imm;
+                auto& range = ranges[inst.a];
+                auto same = std::find_if(block_checks.begin(), block_checks.end(), [&](value_t t_check) {
+                    auto& other = code->GetInst(t_check);
+                    return other.a == inst.a && other.imm == inst.imm && code->GetInst(other.b).imm == high;
+                });
+                if (range.first >= inst.imm && range.second <= high) {
+                    inst = { SsaOp::copy, b, inst.a, SsaCode::NO_VALUE, 0, NO_SYMBOL };
+                    checks++;
+                }
+                else if (same != block_checks.end()) {
+                    inst = { SsaOp::copy, b, *same, SsaCode::NO_VALUE, 0, NO_SYMBOL };
+                    checks++;
+                }
+                else
+                    block_checks.push_back(value);
+            }
+            ranges[value] = getRange(value);
+            ranged[value] = true;
+        }
+    }
+    return checks != before;
+}
+
+
+// range of value by ranges of its operands, FULL_RANGE if it isn't known
+SsaOptimizer::Range SsaOptimizer::getRange(value_t t_value) const {
+    auto& inst = code->GetInst(t_value);
+    auto fit = [](int64_t t_low, int64_t t_high) {
+        return (t_low < INT_MIN || t_high > INT_MAX) ? FULL_RANGE : Range(t_low, t_high);
+    };
+
+    switch (inst.op) {
+    case SsaOp::constant:
+        return { inst.imm, inst.imm };
+    case SsaOp::copy:
+        return ranges[inst.a];
+    case SsaOp::load:
+        return (inst.size == 1) ? Range(0, UINT8_MAX) : FULL_RANGE;
+    case SsaOp::compare:
+        return { 0, 1 };
+    case SsaOp::select:
+        return { std::min(ranges[inst.a].first, ranges[inst.b].first),
+            std::max(ranges[inst.a].second, ranges[inst.b].second) };
+    case SsaOp::check:
+        return { std::max(ranges[inst.a].first, static_cast<int64_t>(inst.imm)),
+            std::min(ranges[inst.a].second, static_cast<int64_t>(code->GetInst(inst.b).imm)) };
+    case SsaOp::phi:
+        return getPhiRange(t_value);
+    default:
+        break;
+    }
+    if (!SsaCode::IsBinary(inst.op))
+        return FULL_RANGE;
+
+    auto a = ranges[inst.a];
+    auto b = ranges[inst.b];
+    switch (inst.op) {
+    case SsaOp::add:
+        return fit(a.first + b.first, a.second + b.second);
+    case SsaOp::sub:
+        return fit(a.first - b.second, a.second - b.first);
+    case SsaOp::mul: {
+        int64_t ends[] = { a.first * b.first, a.first * b.second, a.second * b.first, a.second * b.second };
+        return fit(*std::min_element(std::begin(ends), std::end(ends)), *std::max_element(std::begin(ends), std::end(ends)));
+    }
+    case SsaOp::div:
+        // truncation keeps order, -2^31 div -1 wraps
+        if (b.first != b.second || b.first == 0 || b.first == -1)
+            return FULL_RANGE;
+        if (b.first > 0)
+            return { a.first / b.first, a.second / b.first };
+        return { a.second / b.first, a.first / b.first };
+    case SsaOp::and_:
+        if (a.first >= 0 && b.first >= 0)
+            return { 0, std::min(a.second, b.second) };
+        if (a.first >= 0 || b.first >= 0)
+            return { 0, (a.first >= 0) ? a.second : b.second };
+        return FULL_RANGE;
+    default:
+        return FULL_RANGE;
+    }
+}
+
+
+// union of arguments which are found, else range of variable of for loop
+SsaOptimizer::Range SsaOptimizer::getPhiRange(value_t t_value) const {
+    auto& args = code->GetArgs(t_value);
+    if (std::all_of(args.begin(), args.end(), [this](value_t t_arg) { return ranged[t_arg]; })) {
+        Range range(INT64_MAX, INT64_MIN);
+        for (auto arg : args) {
+            range.first = std::min(range.first, ranges[arg].first);
+            range.second = std::max(range.second, ranges[arg].second);
+        }
+        return args.empty() ? FULL_RANGE : range;
+    }
+
+    auto head = code->GetInst(t_value).block;
+    auto& preds = code->GetBlock(head).preds;
+    if (preds.size() != 2)
+        return FULL_RANGE;
+    auto latch_index = (places[preds[0]] >= places[head]) ? 0 : 1;
+    auto latch = preds[latch_index];
+    auto init = args[1 - latch_index];
+    auto& latch_block = code->GetBlock(latch);
+    auto& step = code->GetInst(args[latch_index]);
+    if (!ranged[init] || places[preds[1 - latch_index]] >= places[head] || step.op != SsaOp::add ||
+        latch_block.exit != SsaExit::branch || latch_block.lhs != t_value || latch_block.succ[0] != head ||
+        !ranged[latch_block.rhs])
+        return FULL_RANGE;
+
+    // the step is v + 1 while v < bound or v + (-1) while v > bound
+    auto other = (step.a == t_value) ? step.b : step.a;
+    auto& increment = code->GetInst(other);
+    if ((step.a != t_value && step.b != t_value) || increment.op != SsaOp::constant)
+        return FULL_RANGE;
+    auto& bound = ranges[latch_block.rhs];
+    if (increment.imm == 1 && latch_block.cond == OpKind::lt)
+        return { ranges[init].first, std::max(ranges[init].second, bound.second) };
+    if (increment.imm == -1 && latch_block.cond == OpKind::gt)
+        return { std::min(ranges[init].first, bound.first), ranges[init].second };
+    return FULL_RANGE;
+}
+
+
+/**
+ * @brief Loop-invariant code motion over loops, inner loops go first: a head
+ *        of loop has a predecessor which isn't before it in order
+ * @param none
+ *
+ * @return true if code is changed
+ * @note A loop which is done is one block of the loop around it, so a block
+ * is walked once however deep it's nested
+ */
+bool SsaOptimizer::hoistInvariants() {
+    auto& order = code->GetOrder();
+    auto blocks = code->GetBlockCount();
+    places.assign(blocks, 0);
+    for (size_t i = 0; i < order.size(); i++)
+        places[order[i]] = static_cast<uint32_t>(i);
+    outer.resize(blocks);
+    for (block_t b = 0; b < blocks; b++)
+        outer[b] = b;
+    loop_index.assign(blocks, NO_LOOP);
+    loops.clear();
+    loop_marks.assign(blocks, SsaCode::NO_BLOCK);
+    exit_marks.assign(blocks, SsaCode::NO_BLOCK);
+    idoms.assign(blocks, SsaCode::NO_BLOCK);
+
+    auto before = hoisted;
+    for (auto i = order.size(); i-- > 0; ) {
+        auto head = order[i];
+        auto& preds = code->GetBlock(head).preds;
+        if (std::any_of(preds.begin(), preds.end(), [&](block_t t_pred) { return places[t_pred] >= i; }))
+            hoistLoop(head);
+    }
+    return hoisted != before;
+}
+
+
+/**
+ * @brief Move invariant values of loop to the end of its preheader in order
+ *        of code, a moved value is out of the loop for values after it
+ * @param[in] t_head - head of loop
+ *
+ * @return none
+ * @note Values of nested loops aren't walked: one which is left in a nested
+ * loop has an operand, a store or an exit in it, they are in this loop too
+ */
+void SsaOptimizer::hoistLoop(block_t t_head) {
+    auto height = findLoop(t_head);
+    loads.clear();
+    stores.clear();
+    exits.clear();
+    if (height <= MAX_HEIGHT) {
+        findMemory(t_head);
+        findExits(t_head);
+    }
+    for (auto b : body) {
+        if (b != t_head && loop_index[b] != NO_LOOP)
+            loops[loop_index[b]] = Loop(); // its memory and exits are taken
+        outer[b] = t_head;
+    }
+
+    auto pre = (height <= MAX_HEIGHT) ? findPreheader(t_head) : SsaCode::NO_BLOCK;
+    if (pre != SsaCode::NO_BLOCK) {
+        auto& pre_code = code->GetBlock(pre).code;
+        for (auto b : body) {
+            if (b != t_head && loop_index[b] != NO_LOOP)
+                continue;
+            auto& list = code->GetBlock(b).code;
+            auto moved = false;
+            for (auto value : list) {
+                if (!isInvariant(value, t_head))
+                    continue;
+                auto& inst = code->GetInst(value);
+                inst.block = pre;
+                pre_code.push_back(value);
+                moved = true;
+                if (inst.op == SsaOp::load || inst.op == SsaOp::store)
+                    forgetMemory((inst.op == SsaOp::load) ? loads : stores, inst);
+                if (inst.op != SsaOp::constant && inst.op != SsaOp::address)
+                    hoisted++;
+            }
+            if (moved) {
+                list.erase(std::remove_if(list.begin(), list.end(),
+                    [&](value_t t_value) { return code->GetInst(t_value).block != b; }), list.end());
+            }
+        }
+    }
+
+    loop_index[t_head] = static_cast<uint32_t>(loops.size());
+    loops.push_back({ height, std::move(loads), std::move(stores), std::move(exits) });
+}
+
+
+/**
+ * @brief Find blocks of loop: the head and blocks which reach a back edge
+ *        without the head
+ * @param[in] t_head - head of loop
+ *
+ * @return 1 + levels of loops nested in it
+ * @note A block after 'break' doesn't reach the back edge, it's out of loop.
+ * A nested loop is walked as its head
+ */
+uint32_t SsaOptimizer::findLoop(block_t t_head) {
+    auto add = [this, t_head](block_t t_block) {
+        auto block = getOuter(t_block);
+        if (loop_marks[block] != t_head) {
+            loop_marks[block] = t_head;
+            body.push_back(block);
+        }
+    };
+
+    body.assign(1, t_head);
+    loop_marks[t_head] = t_head;
+    for (auto pred : code->GetBlock(t_head).preds) {
+        if (places[pred] >= places[t_head])
+            add(pred);
+    }
+    uint32_t height = 1;
+    for (size_t i = 1; i < body.size(); i++) {
+        if (loop_index[body[i]] != NO_LOOP)
+            height = std::max(height, loops[loop_index[body[i]]].height + 1);
+        for (auto pred : code->GetBlock(body[i]).preds)
+            add(pred);
+    }
+    std::sort(body.begin(), body.end(), [this](block_t t_a, block_t t_b) { return places[t_a] < places[t_b]; });
+    return height;
+}
+
+
+// memory which blocks of loop load and store, nested loops give theirs
+void SsaOptimizer::findMemory(block_t t_head) {
+    for (auto b : body) {
+        if (b != t_head && loop_index[b] != NO_LOOP) {
+            auto& nested = loops[loop_index[b]];
+            loads.insert(loads.end(), nested.loads.begin(), nested.loads.end());
+            stores.insert(stores.end(), nested.stores.begin(), nested.stores.end());
+            continue;
+        }
+        for (auto value : code->GetBlock(b).code) {
+            auto& inst = code->GetInst(value);
+            if (inst.op == SsaOp::load)
+                loads.emplace_back(getMemory(inst), 1);
+            else if (inst.op == SsaOp::store)
+                stores.emplace_back(getMemory(inst), 1);
+        }
+    }
+    mergeMemory(loads);
+    mergeMemory(stores);
+}
+
+
+// the only block out of loop which jumps to the head, NO_BLOCK if it isn't one
+block_t SsaOptimizer::findPreheader(block_t t_head) {
+    auto pre = SsaCode::NO_BLOCK;
+    for (auto pred : code->GetBlock(t_head).preds) {
+        if (getOuter(pred) == t_head)
+            continue;
+        if (pre != SsaCode::NO_BLOCK)
+            return SsaCode::NO_BLOCK;
+        pre = pred;
+    }
+    if (pre != SsaCode::NO_BLOCK && code->GetBlock(pre).exit != SsaExit::jump)
+        return SsaCode::NO_BLOCK;
+    return pre;
+}
+
+
+/**
+ * @brief Mark blocks of loop which run before every exit of it: dominators of
+ *        blocks with an edge out of loop
+ * @param[in] t_head - head of loop
+ *
+ * @return none
+ * @note The order of code is a reverse postorder of the loop without back
+ * edges, so a block comes after all predecessors which dominate it. A nested
+ * loop is entered by its head only, it stands for its blocks
+ */
+void SsaOptimizer::findExits(block_t t_head) {
+    auto common = SsaCode::NO_BLOCK;    // dominator of exits which are found
+    auto leave = [&](block_t t_block, block_t t_to) {
+        common = (common == SsaCode::NO_BLOCK) ? t_block : intersect(common, t_block);
+        exits.push_back(t_to);
+    };
+
+    idoms[t_head] = t_head;
+    for (auto b : body) {
+        auto& block = code->GetBlock(b);
+        if (b != t_head) {
+            auto idom = SsaCode::NO_BLOCK;
+            for (auto pred : block.preds) {
+                auto from = getOuter(pred);
+                if (loop_marks[from] == t_head && places[pred] < places[b])
+                    idom = (idom == SsaCode::NO_BLOCK) ? from : intersect(idom, from);
+            }
+            idoms[b] = (idom == SsaCode::NO_BLOCK) ? t_head : idom;
+        }
+        if (b != t_head && loop_index[b] != NO_LOOP) {
+            for (auto to : loops[loop_index[b]].exits) {
+                if (loop_marks[getOuter(to)] != t_head)
+                    leave(b, to);
+            }
+            continue;
+        }
+        for (auto succ : block.succ) {
+            if (succ != SsaCode::NO_BLOCK && loop_marks[getOuter(succ)] != t_head)
+                leave(b, succ);
+        }
+    }
+    std::sort(exits.begin(), exits.end());
+    exits.erase(std::unique(exits.begin(), exits.end()), exits.end());
+
+    // a loop without exits has no such blocks
+    if (common == SsaCode::NO_BLOCK)
+        return;
+    for (auto b = common; b != t_head; b = idoms[b])
+        exit_marks[b] = t_head;
+    exit_marks[t_head] = t_head;
+}
+
+
+// head of the outermost loop which is found around block, the block if none
+block_t SsaOptimizer::getOuter(block_t t_block) {
+    auto root = t_block;
+    while (outer[root] != root)
+        root = outer[root];
+    while (outer[t_block] != root) {
+        auto next = outer[t_block];
+        outer[t_block] = root;
+        t_block = next;
+    }
+    return root;
+}
+
+
+/**
+ * @brief Check if value may be computed once before the loop: its operands
+ *        are out of loop and it can't fault or it runs before every exit
+ * @param[in] t_value - value in the loop
+ * @param[in] t_head  - head of loop
+ *
+ * @return true if value is moved to the preheader
+ */
+bool SsaOptimizer::isInvariant(value_t t_value, block_t t_head) {
+    auto& inst = code->GetInst(t_value);
+    auto outside = [&](value_t t_arg) { return getOuter(code->GetInst(t_arg).block) != t_head; };
+
+    switch (inst.op) {
+    case SsaOp::constant:
+    case SsaOp::address:
+        return true;
+    case SsaOp::load:
+        if (inst.b != SsaCode::NO_VALUE && (!outside(inst.b) || exit_marks[inst.block] != t_head))
+            return false;
+        return countMemory(stores, inst) == 0;
+    case SsaOp::store:
+        // the last value of memory is the one of the first pass
+        if (inst.b != SsaCode::NO_VALUE && !outside(inst.b))
+            return false;
+        return outside(inst.a) && exit_marks[inst.block] == t_head
+            && countMemory(stores, inst) == 1 && countMemory(loads, inst) == 0;
+    case SsaOp::check:
+        return outside(inst.a) && exit_marks[inst.block] == t_head;
+    case SsaOp::copy:
+        return outside(inst.a);
+    case SsaOp::select:
+        return outside(inst.a) && outside(inst.b) && outside(inst.c);
+    case SsaOp::div: {
+        auto& divisor = code->GetInst(inst.b);
+        if (divisor.op != SsaOp::constant || divisor.imm == 0)
+            return false;
+        return outside(inst.a) && outside(inst.b);
+    }
+    default:
+        return (SsaCode::IsBinary(inst.op) || inst.op == SsaOp::compare) && outside(inst.a) && outside(inst.b);
+    }
+}
+
+
+block_t SsaOptimizer::intersect(block_t t_a, block_t t_b) const {
+    while (t_a != t_b) {
+        while (places[t_a] > places[t_b])
+            t_a = idoms[t_a];
+        while (places[t_b] > places[t_a])
+            t_b = idoms[t_b];
+    }
+    return t_a;
+}
+
+
+// memory of load or store, an element by index is at ANY_OFFSET
+SsaOptimizer::Memory SsaOptimizer::getMemory(const SsaCode::Inst& t_inst) {
+    return Memory(t_inst.sym, (t_inst.b != SsaCode::NO_VALUE) ? ANY_OFFSET : t_inst.imm);
+}
+
+
+// number of loads or stores of the loop to memory of instruction, elements don't overlap,
+// an element by index may be any of them
+size_t SsaOptimizer::countMemory(const std::vector<Access>& t_list, const SsaCode::Inst& t_inst) {
+    auto count = [&t_list](Memory t_first, Memory t_last) {
+        size_t number = 0;
+        for (auto it = std::lower_bound(t_list.begin(), t_list.end(), Access(t_first, 0));
+             it != t_list.end() && it->first <= t_last; ++it)
+            number += it->second;
+        return number;
+    };
+    if (t_inst.b != SsaCode::NO_VALUE)
+        return count(Memory(t_inst.sym, INT_MIN), Memory(t_inst.sym, INT_MAX));
+
+    auto memory = getMemory(t_inst);
+    return count(memory, memory) + count(Memory(t_inst.sym, ANY_OFFSET), Memory(t_inst.sym, ANY_OFFSET));
+}
+
+
+// sorts loads or stores of the loop and adds up the numbers of the same memory
+void SsaOptimizer::mergeMemory(std::vector<Access>& t_list) {
+    std::sort(t_list.begin(), t_list.end());
+    size_t size = 0;
+    for (auto& access : t_list) {
+        if (access.second == 0)
+            continue;
+        if (size > 0 && t_list[size - 1].first == access.first)
+            t_list[size - 1].second += access.second;
+        else
+            t_list[size++] = access;
+    }
+    t_list.resize(size);
+}
+
+
+// load or store of instruction is moved out of the loop
+void SsaOptimizer::forgetMemory(std::vector<Access>& t_list, const SsaCode::Inst& t_inst) {
+    auto it = std::lower_bound(t_list.begin(), t_list.end(), Access(getMemory(t_inst), 0));
+    if (it != t_list.end() && it->first == getMemory(t_inst) && it->second > 0)
+        it->second--;
+}
@@ -0,0 +1,156 @@
+#ifndef SSAOPTIMIZER_H
+#define SSAOPTIMIZER_H
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "SsaCode.h"
+
+/*
+ * Passes over SsaCode before it's lowered to MachineCode:
+ *  - sparse conditional constant propagation finds values which are constant
+ *    on the paths that run, folds branches on them and drops blocks which
+ *    aren't reached;
+ *  - copy propagation replaces a copy or a phi of one value by the value;
+ *  - dead code elimination removes values which no store, branch or used
+ *    value needs. Division stays unless its divisor is a constant other than
+ *    zero, division by zero isn't lost;
+ *  - loop-invariant code motion moves values of a loop whose operands come
+ *    from outside of it to the preheader, which runs only if the loop does.
+ *    Loads go if the loop doesn't store their memory, a store goes if it's
+ *    the only access to its memory in the loop and runs before every exit.
+ *    Inner loops go first, so a value may leave several loops. A loop with
+ *    more than MAX_HEIGHT levels of loops in it keeps its code, a value
+ *    leaves a bounded number of loops however deep they are nested;
+ *  - if-conversion replaces a branch around one or two small blocks which
+ *    can't fault by selects of the values that join after them, their code
+ *    runs on both paths;
+ *  - range analysis removes a check of index whose value is always in range
+ *    of array or is checked before in its block.
+ *
+ * -O0 keeps the code, -O1 runs the passes once, -O2 repeats them until no
+ * pass changes the code. Checks are removed and code is moved once after them.
+ */
+class SsaOptimizer
+{
+public:
+	explicit SsaOptimizer(int t_level) : level(t_level) {};
+
+	size_t		Run(SsaCode& t_code);		// number of removed values
+
+	size_t		GetFolded() const { return folded; }
+	size_t		GetBranches() const { return branches; }
+	size_t		GetDeadBlocks() const { return dead_blocks; }
+	size_t		GetCopies() const { return copies; }
+	size_t		GetDeadValues() const { return dead_values; }
+	size_t		GetRounds() const { return rounds; }
+	size_t		GetHoisted() const { return hoisted; }
+	size_t		GetSelects() const { return selects; }
+	size_t		GetChecks() const { return checks; }
+
+private:
+	static constexpr size_t MAX_ROUNDS = 8;
+	static constexpr size_t MAX_ARM = 2;		// instructions of block which is if-converted
+	static constexpr size_t MAX_SELECTS = 2;	// phis of its join
+	static constexpr uint32_t MAX_HEIGHT = 32;	// levels of loops in a loop which moves code
+
+	using value_t = SsaCode::value_t;
+	using block_t = SsaCode::block_t;
+
+	// lattice of value: not known yet, constant, any value
+	enum State : uint8_t { top, constant, bottom };
+
+	int						level;
+	SsaCode*				code{ nullptr };
+	size_t					folded{ 0 };		// values replaced by constants, selects by operands
+	size_t					branches{ 0 };		// branches replaced by jumps
+	size_t					dead_blocks{ 0 };
+	size_t					copies{ 0 };
+	size_t					dead_values{ 0 };
+	size_t					rounds{ 0 };
+	size_t					hoisted{ 0 };		// instructions moved out of loops, not constants
+	size_t					selects{ 0 };		// branches replaced by selects
+	size_t					checks{ 0 };		// checks of index removed
+
+	// state of constant propagation
+	std::vector<State>		states;
+	std::vector<int>		numbers;			// value of constant
+	std::vector<bool>		reached;			// block runs
+	std::vector<uint32_t>	edge_first;			// block -> its edges in 'edges_run'
+	std::vector<bool>		edges_run;			// edge from predecessor runs
+	std::vector<uint32_t>	user_first;			// value -> its users in 'users'
+	std::vector<value_t>	users;				// instructions which use value
+	std::vector<uint32_t>	branch_first;		// value -> blocks in 'branch_users'
+	std::vector<block_t>	branch_users;		// blocks which branch on value
+	std::vector<std::pair<block_t, block_t>>	flow_list;
+	std::vector<value_t>	value_list;
+
+	// state of range analysis: [low, high] of every value
+	using Range = std::pair<int64_t, int64_t>;
+	static constexpr Range FULL_RANGE{ INT_MIN, INT_MAX };
+
+	std::vector<Range>		ranges;
+	std::vector<bool>		ranged;				// range of value is found
+
+	// state of code motion, blocks are marked by the head of loop. Loops are
+	// done inner first, then a loop is one block of the loop around it
+	using Memory = std::pair<symbol_t, int>;	// symbol and offset of load or store
+	using Access = std::pair<Memory, uint32_t>;	// memory and number of its loads or stores
+	static constexpr int ANY_OFFSET = INT_MIN;	// element by index
+	static constexpr uint32_t NO_LOOP = UINT32_MAX;
+
+	// what a loop which is done gives to the loop around it
+	struct Loop {
+		uint32_t				height;			// 1 + levels of loops nested in it
+		std::vector<Access>		loads;
+		std::vector<Access>		stores;
+		std::vector<block_t>	exits;			// blocks out of loop which it jumps to
+	};
+
+	std::vector<uint32_t>	places;				// block -> its place in order
+	std::vector<block_t>	outer;				// union-find: block -> outermost loop done around it
+	std::vector<uint32_t>	loop_index;			// head -> its loop in 'loops', NO_LOOP if not done
+	std::vector<Loop>		loops;
+	std::vector<block_t>	loop_marks;			// block or nested loop is in the loop
+	std::vector<block_t>	exit_marks;			// block runs before every exit of the loop
+	std::vector<block_t>	idoms;				// immediate dominator in the loop
+	std::vector<block_t>	body;				// blocks and heads of nested loops in order
+	std::vector<Access>		loads;				// memory loaded in the loop, sorted
+	std::vector<Access>		stores;				// memory stored in the loop, sorted
+	std::vector<block_t>	exits;				// blocks out of the loop which it jumps to
+
+	bool		propagateConstants();
+	void		findUsers();
+	void		visit(value_t t_value);
+	void		visitExit(block_t t_block);
+	void		runEdge(block_t t_from, block_t t_to);
+	void		lower(value_t t_value, State t_state, int t_number);
+	void		rewriteConstants();
+
+	bool		propagateCopies();
+	bool		eliminateDeadCode();
+	bool		selectBranches();
+	bool		isArm(block_t t_block, block_t t_branch) const;
+
+	bool		removeChecks();
+	Range		getRange(value_t t_value) const;
+	Range		getPhiRange(value_t t_value) const;
+
+	bool		hoistInvariants();
+	void		hoistLoop(block_t t_head);
+	uint32_t	findLoop(block_t t_head);
+	void		findMemory(block_t t_head);
+	block_t		findPreheader(block_t t_head);
+	void		findExits(block_t t_head);
+	block_t		getOuter(block_t t_block);
+	bool		isInvariant(value_t t_value, block_t t_head);
+	block_t		intersect(block_t t_a, block_t t_b) const;
+	static Memory	getMemory(const SsaCode::Inst& t_inst);
+	static size_t	countMemory(const std::vector<Access>& t_list, const SsaCode::Inst& t_inst);
+	static void		mergeMemory(std::vector<Access>& t_list);
+	static void		forgetMemory(std::vector<Access>& t_list, const SsaCode::Inst& t_inst);
+};
+
+#endif // !SSAOPTIMIZER_H
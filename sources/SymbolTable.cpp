@@ -0,0 +1,88 @@
+#include "SymbolTable.h"
+
+SymbolTable::SymbolTable() {
+    slots.assign(64, { NO_SYMBOL, NO_VAR });
+    OpenScope();
+}
+
+void SymbolTable::OpenScope() {
+    scopes.push_back(vars.size());
+}
+
+/**
+ * @brief Drop variables of the innermost scope, names hidden by them are
+ *        visible again
+ * @param none
+ *
+ * @return none
+ */
+void SymbolTable::CloseScope() {
+    if (scopes.empty())
+        throw std::logic_error("<E> SymbolTable: No scope to close");
+
+    for (auto first = scopes.back(); vars.size() > first; vars.pop_back())
+        slots[findSlot(vars.back().name)].var = vars.back().outer;
+    scopes.pop_back();
+}
+
+/**
+ * @brief Add variable in the current scope
+ * @param[in] t_name - symbol id of name
+ *
+ * @return new variable or nullptr if the scope has the name already
+ */
+Variable* SymbolTable::Declare(symbol_t t_name) {
+    auto& slot = slots[findSlot(t_name)];
+    if (slot.name == t_name && slot.var != NO_VAR && vars[slot.var].scope == GetDepth())
+        return nullptr;
+
+    Variable var(t_name);
+    var.scope = GetDepth();
+    if (slot.name == t_name)
+        var.outer = slot.var;
+    else {
+        slot.name = t_name;
+        names++;
+    }
+    slot.var = static_cast<uint32_t>(vars.size());
+    vars.push_back(std::move(var));
+
+    if (names * 2 > slots.size()) // keep load factor under 0.5
+        grow();
+    return &vars.back();
+}
+
+Variable* SymbolTable::Find(symbol_t t_name) {
+    auto& slot = slots[findSlot(t_name)];
+    return (slot.name == t_name && slot.var != NO_VAR) ? &vars[slot.var] : nullptr;
+}
+
+const Variable* SymbolTable::Find(symbol_t t_name) const {
+    auto& slot = slots[findSlot(t_name)];
+    return (slot.name == t_name && slot.var != NO_VAR) ? &vars[slot.var] : nullptr;
+}
+
+Variable& SymbolTable::At(symbol_t t_name) {
+    auto* var = Find(t_name);
+    if (var == nullptr)
+        throw std::out_of_range("<E> SymbolTable: Unknown identifier");
+    return *var;
+}
+
+size_t SymbolTable::findSlot(symbol_t t_name) const {
+    auto mask = slots.size() - 1;
+    for (size_t i = t_name & mask; ; i = (i + 1) & mask) { // ids are small numbers in order of interning
+        if (slots[i].name == t_name || slots[i].name == NO_SYMBOL)
+            return i;
+    }
+}
+
+void SymbolTable::grow() {
+    auto old = std::move(slots);
+    slots.assign(old.size() * 2, { NO_SYMBOL, NO_VAR });
+
+    for (auto& slot : old) {
+        if (slot.name != NO_SYMBOL)
+            slots[findSlot(slot.name)] = slot;
+    }
+}
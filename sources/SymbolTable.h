@@ -0,0 +1,51 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Variable.h"
+
+/*
+ * Table of declared variables with nested scopes. Names are found by their
+ * symbol id in an open addressing table, a slot keeps the innermost visible
+ * declaration of the name and the declaration keeps the one it hides. Closing
+ * a scope puts the hidden declarations back.
+ *
+ * Pointers to variables are valid until the next Declare().
+ */
+class SymbolTable
+{
+public:
+	SymbolTable();		// global scope is open
+
+	void			OpenScope();
+	void			CloseScope();
+	int				GetDepth() const { return static_cast<int>(scopes.size()); }
+
+	Variable*		Declare(symbol_t t_name);	// nullptr if name is in the current scope already
+	Variable*		Find(symbol_t t_name);		// nullptr if name isn't visible
+	const Variable*	Find(symbol_t t_name) const;
+	Variable&		At(symbol_t t_name);		// throws if name isn't visible
+
+	size_t			size() const { return vars.size(); }
+
+private:
+	static constexpr uint32_t NO_VAR = UINT32_MAX;
+
+	struct Slot {
+		symbol_t	name;
+		uint32_t	var;	// innermost declaration or NO_VAR
+	};
+
+	std::vector<Variable>	vars;		// visible and hidden declarations, inner scopes last
+	std::vector<Slot>		slots;		// power of 2 size
+	std::vector<size_t>		scopes;		// first variable of every open scope
+	size_t					names{ 0 };	// used slots
+
+	size_t		findSlot(symbol_t t_name) const;	// slot of name or empty one
+	void		grow();
+};
+
+#endif // !SYMBOL_TABLE_H
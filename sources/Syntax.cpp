@@ -1,982 +1,1125 @@
-#include "Syntax.h"
-
-
-Syntax::Syntax(std::vector<Lexem>&& t_lex_table) {
-    if (t_lex_table.empty())
-        throw std::runtime_error("<E> Syntax: Lexemes table is empty");
-    if (t_lex_table.at(0).GetToken() == eof_tk)
-        throw std::runtime_error("<E> Syntax: Code file is empty");
-    lex_table = t_lex_table;
-    cursor = lex_table.begin();
-
-    operations.emplace(":=", 0);
-
-    operations.emplace("=", 1);
-    operations.emplace("<>", 1);
-    operations.emplace("<", 1);
-    operations.emplace(">", 1);
-    operations.emplace("<=", 1);
-    operations.emplace(">=", 1);
-
-    operations.emplace("+", 2);
-    operations.emplace("-", 2);
-    operations.emplace("or", 2);
-    operations.emplace("xor", 2);
-
-    operations.emplace("*", 3);
-    operations.emplace("div", 3);
-
-    operations.emplace("(", 4);
-    operations.emplace(")", 4);
-}
-
-Syntax::~Syntax() {
-    Tree::FreeTree(root_tree);
-}
-
-
-Tree* Syntax::ParseCode() {
-    std::cout << "Code contains " << lex_table.size() << " lexemes" << std::endl;
-    auto& it = cursor;
-    if (programParse(it) != 0)
-        return nullptr;
-
-    while (it != lex_table.end() && it->GetToken() != eof_tk)
-        blockParse(it);
-
-    if (!error) {
-        std::cout << std::endl;
-        std::cout << std::setfill('*') << std::setw(50);
-        std::cout << "\r\n";
-
-        root_tree->PrintTree(0);
-    }
-    
-    std::cout << "EOF" << std::endl;
-
-    return root_tree;
-}
-
-Syntax::lex_it Syntax::getNextLex(lex_it& iter) {
-    try {
-        if (iter != lex_table.end())
-            iter++;
-    }
-    catch (const std::exception & exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-            << exp.what() << std::endl;
-    }
-
-    return iter;
-}
-
-Syntax::lex_it Syntax::getPrevLex(lex_it& iter) {
-    try {
-        if (iter != lex_table.begin())
-            iter--;
-    }
-    catch (const std::exception& exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-            << exp.what() << std::endl;
-    }
-
-    return iter;
-}
-
-Syntax::lex_it Syntax::peekLex(int N, lex_it t_iter) {
-    try {
-        auto iter = t_iter;
-        while (iter != lex_table.end()) {
-            if (N == 0) return iter;
-            iter++; N--;
-        }
-
-        return iter;
-    }
-    catch (const std::exception &) {
-        std::cerr << "<E> Syntax: Can't peek so forward" << std::endl;
-        return t_iter;
-    }
-}
-
-Syntax::lex_it Syntax::peekPrevLex(int N, lex_it t_iter) {
-    try {
-        auto iter = t_iter;
-        while (iter != lex_table.end()) {
-            if (N == 0) return iter;
-            iter--; N--;
-        }
-
-        return iter;
-    }
-    catch (const std::exception&) {
-        std::cerr << "<E> Syntax: Can't peek so backward" << std::endl;
-        return t_iter;
-    }
-}
-
-int Syntax::programParse(lex_it &t_iter) {
-    if (!checkLexem(t_iter, program_tk)) {
-        printError(MUST_BE_PROG, *t_iter);
-        return -EXIT_FAILURE;
-    }
-
-    auto iter = getNextLex(t_iter);
-
-    if (!checkLexem(iter, id_tk)) {
-        if (iter->GetToken() == eof_tk) {
-            printError(EOF_ERR, *iter);
-            return -EXIT_FAILURE;
-        }
-        else {
-            printError(MUST_BE_ID, *iter);
-            return -EXIT_FAILURE;
-        }
-    }
-
-    auto root_name = iter->GetName(); // save the name of program
-
-    iter = getNextLex(t_iter);
-
-    if (!checkLexem(iter, semi_tk)) {
-        if (iter->GetToken() == eof_tk) {
-            printError(EOF_ERR, *iter);
-            return -EXIT_FAILURE;
-        }
-        else {
-            printError(MUST_BE_SEMI, *iter);
-            return -EXIT_FAILURE;
-        }
-    } 
-        root_tree = Tree::CreateNode(root_name);
-
-    return EXIT_SUCCESS;
-}
-
-int Syntax::blockParse(lex_it& t_iter) {
-    try {
-        auto iter = getNextLex(t_iter);
-        switch (iter->GetToken()) {
-        case var_tk: {
-            root_tree->AddLeftNode("var");
-            vardpParse(t_iter, root_tree->GetLeftNode()); 
-            break;
-        }
-        case begin_tk: {
-            root_tree->AddRightTree(compoundParse(t_iter, 0));
-            break;
-        }
-        case dot_tk: {
-            if (!error) std::cout << "Program was parse successfully" << std::endl;
-            break;
-        }
-        default: {
-            break;
-        }
-        }
-    }
-    catch (const std::exception & exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-            << exp.what() << std::endl;
-        return -EXIT_FAILURE;
-    }
-
-    return EXIT_SUCCESS;
-}
-
-std::list<std::string> Syntax::vardParse(lex_it& t_iter) {
-    auto iter = getNextLex(t_iter);
-    if (!checkLexem(iter, id_tk)) {
-        printError(MUST_BE_ID, *iter);
-        return std::list<std::string>();
-    }
-
-    if (isVarExist(iter->GetName())) printError(DUPL_ID_ERR, *iter);
-    else id_map.emplace(iter->GetName(), Variable("?", "?"));
-
-    std::list<std::string> var_list;
-    var_list.push_back(t_iter->GetName());
-
-    iter = getNextLex(t_iter);
-
-    if (checkLexem(iter, comma_tk))
-        var_list.splice(var_list.end(), vardParse(t_iter));
-
-    return var_list;
-}
-
-int Syntax::vardpParse(lex_it& t_iter, Tree *t_tree) {
-    auto var_list = vardParse(t_iter);
-    auto* tree_value = Tree::CreateNode("");
-    bool isArray{ false };
-
-    if (!checkLexem(t_iter, ddt_tk)) {
-        printError(MUST_BE_COMMA, *t_iter);
-    }
-
-    auto type_iter = getNextLex(t_iter);
-
-    if (t_iter->GetToken() == arr_tk) {
-        tree_value->ChangeValue(t_iter->GetName());
-        tree_value->AddLeftNode("range");
-        getNextLex(t_iter);
-
-        if (!checkLexem(t_iter, osb_tk)) {
-            printError(MUST_BE_ARRBRACKET, *t_iter);
-        }
-
-        getNextLex(t_iter);
-
-        if (!checkLexem(t_iter, constant_tk)) {
-            printError(MUST_BE_ID, *t_iter);
-        }
-
-        tree_value->GetLeftNode()->AddLeftNode(t_iter->GetName());
-        getNextLex(t_iter);
-
-        if (!checkLexem(t_iter, dots_arr_tk)) {
-            printError(MUST_BE_DOTS_ARR, *t_iter);
-        }
-
-        getNextLex(t_iter);
-      
-        if (!checkLexem(t_iter, constant_tk)) {
-            printError(MUST_BE_ID, *t_iter);
-        }
-
-        tree_value->GetLeftNode()->AddRightNode(t_iter->GetName());
-        getNextLex(t_iter);
-
-        if (!checkLexem(t_iter, csb_tk)) {
-            printError(MUST_BE_ARRBRACKET_END, *t_iter);
-        }
-
-        getNextLex(t_iter);
-
-        if (!checkLexem(t_iter, of_tk)) {
-            printError(MUST_BE_OF, *t_iter);
-        }
-
-        type_iter = getNextLex(t_iter);
-        isArray = true;
-    }
-
-
-    if (!checkLexem(t_iter, type_tk)) {
-        printError(MUST_BE_TYPE, *t_iter);
-    }
-
-    getNextLex(t_iter);
-    if (!checkLexem(t_iter, semi_tk)) {
-        printError(MUST_BE_SEMI, *t_iter);
-    }
-    
-    if (isArray) {
-        std::pair<int, int> range = { std::stoi(tree_value->GetLeftNode()->GetLeftNode()->GetValue()),
-                                        std::stoi(tree_value->GetLeftNode()->GetRightNode()->GetValue()) };
-        updateVarTypes(var_list, type_iter->GetName(), range);
-    }
-    else {
-        updateVarTypes(var_list, type_iter->GetName());
-    }
-
-    if (isArray) {
-        while (t_tree->GetLeftNode() != nullptr)
-            t_tree = t_tree->GetRightNode();
-        buildVarTree(var_list, t_tree, tree_value);
-    }
-    else {
-        if (t_tree->GetValue() == "var") {
-            while (t_tree->GetLeftNode() != nullptr)
-                t_tree = t_tree->GetRightNode();
-            buildVarTree(var_list, t_tree);
-        }
-        else {
-            while (t_tree->GetLeftNode() != nullptr)
-                t_tree = t_tree->GetRightNode();
-            buildVarTree(var_list, t_tree);
-        }
-        Tree::FreeTree(tree_value);
-    }
-
-    
-    if (checkLexem(peekLex(1, t_iter), id_tk) || checkLexem(peekLex(1, t_iter), var_tk)) {
-        if (checkLexem(peekLex(1, t_iter), var_tk))
-            getNextLex(t_iter);
-        vardpParse(t_iter, t_tree->GetRightNode());
-    } else {
-        if (t_tree->GetRightNode()->GetRightNode())
-            t_tree->GetRightNode()->FreeRightNode();
-    }
-   
-    return EXIT_SUCCESS;
-}
-
-Tree* Syntax::stateParse(lex_it& t_iter, int c_count) {
-    Tree *result_tree = nullptr;
-    auto iter = getNextLex(t_iter);
-    switch (iter->GetToken()) {
-    case id_tk: {
-        if (!isVarExist(iter->GetName())) {
-            printError(UNKNOWN_ID, *t_iter);
-            return nullptr;
-        }
-
-        auto var_iter = iter;
-        getNextLex(t_iter);
-
-        if ((!checkLexem(t_iter, ass_tk) && (!checkLexem(t_iter, osb_tk)))) {
-            printError(MUST_BE_ASS, *t_iter);
-            return nullptr;
-        }
-
-        auto *tree_exp = Tree::CreateNode(t_iter->GetName());
-        if (checkLexem(t_iter, osb_tk)) {
-            getNextLex(t_iter);
-            if (!checkLexem(t_iter, constant_tk)) {
-                printError(MUST_BE_CONST, *t_iter);
-                return nullptr;
-            }
-            if (!id_map.find(var_iter->GetName())->second.isarray) {
-                printError(INCORRECT_TYPE, *t_iter);
-                return nullptr;
-            }
-            if (((stoi(t_iter->GetName()) < id_map.find(var_iter->GetName())->second.range.first)) ||
-                ((stoi(t_iter->GetName()) > id_map.find(var_iter->GetName())->second.range.second))) {
-                printError(INCORRECT_RANGE, *t_iter);
-                return nullptr;
-            }
-
-            getNextLex(t_iter);
-            if (!checkLexem(t_iter, csb_tk)) {
-                printError(MUST_BE_ARRBRACKET_END, *t_iter);
-                return nullptr;
-            }
-
-            getNextLex(t_iter);
-            if (!checkLexem(t_iter, ass_tk)) {
-                printError(MUST_BE_ASS, *t_iter);
-                return nullptr;
-            }
-
-            auto save_ass = t_iter;
-
-            tree_exp = Tree::CreateNode(t_iter->GetName());
-            getPrevLex(t_iter);
-            tree_exp->AddLeftNode("array");
-            tree_exp->GetLeftNode()->AddLeftNode(var_iter->GetName(), 0);
-            tree_exp->GetLeftNode()->AddRightNode(getPrevLex(t_iter)->GetName());
-            t_iter = save_ass;
-        }
-        else {
-            tree_exp = Tree::CreateNode(t_iter->GetName());
-            tree_exp->AddLeftNode(var_iter->GetName(), 0);
-        }
-
-
-        expressionParse(t_iter, tree_exp, 0);
-
-        if (!checkLexem(t_iter, semi_tk) && (checkLexem(peekLex(1, t_iter), to_tk))
-                                         && (checkLexem(peekLex(1, t_iter), downto_tk))) { // we exit from expression on the ';'
-            printError(MUST_BE_SEMI, *t_iter);
-            return nullptr;
-        }
-
-        //tree_exp->PrintTree(0);
-        //tree_exp->PrintTree_2();
-
-        result_tree = tree_exp;
-        break;
-    }
-    case begin_tk: {
-        auto *tree_comp = compoundParse(t_iter, c_count);
-        if (!checkLexem(peekLex(1, t_iter), semi_tk)) {
-            printError(MUST_BE_SEMI, *t_iter);
-            return nullptr;
-        }
-        else getNextLex(t_iter);
-
-        if (tree_comp != nullptr)
-            result_tree = tree_comp;
-        break;
-    }
-    case if_tk: {
-        auto* tree_exp = Tree::CreateNode(t_iter->GetName());
-        auto t_lvl = 0;    //if in if...
-
-        expressionParse(t_iter, tree_exp, t_lvl);
-
-        if (tree_exp->GetRightNode() == nullptr) { return nullptr; };
-
-        auto sr = tree_exp->GetRightNode()->GetValue();
-        if ((sr != "<") && (sr != ">") && (sr != "<=") && (sr != ">=") && (sr != "<>")
-            && (sr != "=") && (sr != "true") && (sr != "false")) {
-                printError(MUST_BE_COMP, *t_iter);
-                Tree::FreeTree(tree_exp);
-                return nullptr;
-        }
-
-
-        tree_exp->AddLeftTree(tree_exp->GetRightNode());
-        if (iter->GetToken() == if_tk) {
-            if (t_iter->GetToken() != then_tk) {
-                printError(MUST_BE_THEN, *t_iter);
-                return nullptr;
-            }
-        }
-
-        tree_exp->AddRightNode("then");
-        auto then_exp = tree_exp->GetRightNode();
-        auto var_iter = getNextLex(t_iter);
-        result_tree = tree_exp;
-
-        if (var_iter->GetToken() == break_tk) {
-            then_exp->AddLeftNode("break");
-            then_exp->GetLeftNode()->AddRightNode(breakpoint);
-            getNextLex(var_iter);
-        }
-
-        if ((var_iter->GetToken() == id_tk) || (var_iter->GetToken() == begin_tk)
-            || (var_iter->GetToken() == for_tk) || (var_iter->GetToken() == if_tk)) {
-            var_iter = getPrevLex(var_iter);
-            result_tree->GetRightNode()->AddLeftTree(stateParse(var_iter, c_count));
-        }
-
-
-        if (var_iter->GetToken() == else_tk || getNextLex(var_iter)->GetToken() == else_tk) {
-            then_exp->AddRightNode("else");
-            getNextLex(var_iter);
-
-            if (var_iter->GetToken() == break_tk) {
-                then_exp->GetRightNode()->AddLeftNode("break");
-                then_exp->GetRightNode()->GetLeftNode()->AddRightNode(breakpoint);
-            }
-
-            if ((var_iter->GetToken() == id_tk) || (var_iter->GetToken() == begin_tk)
-                || (var_iter->GetToken() == for_tk) || (var_iter->GetToken() == if_tk)) {
-                var_iter = getPrevLex(var_iter);
-                then_exp->GetRightNode()->AddLeftTree(stateParse(var_iter, c_count));
-            }
-        }
-        getNextLex(var_iter);
-        t_iter = var_iter;
-        break;
-    }
-    case for_tk: {
-        auto* tree_exp = Tree::CreateNode(t_iter->GetName());
-        result_tree = tree_exp;
-        auto t_lvl = 0;   //for in for...
-        auto left_node = stateParse(t_iter, 0);
-
-        if ((!checkLexem(t_iter, to_tk)) && (!checkLexem(t_iter, downto_tk))) {
-            printError(MUST_BE_TO, *t_iter);
-            return nullptr;
-        }
-
-        auto* tree_to = Tree::CreateNode(t_iter->GetName());
-        tree_to->AddLeftTree(left_node);
-        tree_exp->AddLeftTree(tree_to);
-
-        expressionParse(t_iter, tree_exp->GetLeftNode(), t_lvl);
-
-        if (t_iter->GetToken() != do_tk) {
-            printError(MUST_BE_DO, *t_iter);
-            return nullptr;
-        }
-
-        auto var_iter = getNextLex(t_iter);
-
-        if ((var_iter->GetToken() != id_tk) && (var_iter->GetToken() != begin_tk)) {
-            printError(MUST_BE_ID, *t_iter);
-            return nullptr;
-        }
-
-        var_iter = getPrevLex(var_iter);
-        result_tree->AddRightTree(stateParse(var_iter, c_count));
-        t_iter = var_iter;
-
-        break;
-    }
-    default: {
-        break;
-    }
-    }
-    return result_tree;
-}
-
-Tree* Syntax::compoundParse(lex_it& t_iter, int c_count) {
-    c_count++;
-    int local_lvl = c_count; // save current compound level
-    int sec_prm = 0;
-
-    auto label = [&]() -> std::string {
-        return "_op" + std::to_string(local_lvl) + "." +
-            std::to_string(sec_prm);
-    };
-
-    auto is_end = [&]() -> bool {
-        return (checkLexem(peekLex(1, t_iter), end_tk)
-            || checkLexem(peekLex(1, t_iter), eof_tk));
-    };
-
-    Tree *tree = Tree::CreateNode(t_iter->GetName()); // 'begin' node
-    auto* root_compound_tree = tree; // save pointer of start of subtree
-
-    while (t_iter->GetToken() != end_tk) {
-        if (t_iter->GetToken() == eof_tk) {
-            printError(EOF_ERR, *t_iter);
-            return nullptr;
-        }
-        if (t_iter->GetToken() != dot_tk)
-        {
-            if (checkLexem(peekLex(1, t_iter), for_tk)) { breakpoint = label(); };
-            auto *subTree = stateParse(t_iter, c_count);
-            if (subTree != nullptr) {
-                tree->AddRightNode(label());
-                tree->GetRightNode()->AddLeftTree(subTree);
-                tree = tree->GetRightNode();
-
-                if (!is_end()) sec_prm++;
-            }
-        }
-        else break;
-    }
-    
-    if (c_count == 1) {
-        if (checkLexem(peekLex(1, t_iter), unknown_tk) ||
-            checkLexem(peekLex(1, t_iter), eof_tk) ||
-            !checkLexem(peekLex(1, t_iter), dot_tk)) {
-            printError(MUST_BE_DOT, *t_iter);
-            return nullptr;
-        }
-        tree->AddRightNode(t_iter->GetName() + ".");
-    } else
-        tree->AddRightNode(t_iter->GetName());
-    return root_compound_tree;
-}
-
-int Syntax::expressionParse(lex_it& t_iter, Tree *tree, int t_lvl) {
-    lex_it var_iter;
-    Tree *subTree;
-    
-
-    auto iter = getNextLex(t_iter);
-    switch (iter->GetToken()) {
-    case id_tk: { // like a := b;
-        if (!isVarExist(iter->GetName()))
-            printError(UNKNOWN_ID, *t_iter);
-        var_iter = iter;
-        getNextLex(iter);
-
-        if (iter->GetToken() == osb_tk) {
-            if (getNextLex(iter)->GetToken() != constant_tk) {
-                printError(MUST_BE_ID, *t_iter);
-                return -EXIT_FAILURE;
-            }
-            if (getNextLex(iter)->GetToken() != csb_tk) {
-                printError(MUST_BE_ARRBRACKET_END, *t_iter);
-                return -EXIT_FAILURE;
-            }
-            t_iter = iter;
-            auto var_tree = Tree::CreateNode("array");
-            var_tree->AddLeftNode(var_iter->GetName());
-            var_tree->AddRightNode(getPrevLex(iter)->GetName());
-            subTree = simplExprParse(var_tree, t_iter, tree, t_lvl);
-        }
-        else
-        {
-            subTree = simplExprParse(var_iter, t_iter, tree, t_lvl);
-        }
-        break;
-    }
-    case constant_tk: { // like a := 3 ...
-        var_iter = iter;
-        subTree = simplExprParse(var_iter, t_iter, tree, t_lvl);
-        break;
-    }
-    case minus_tk: { // like a := -3;
-        var_iter = t_iter;
-        
-        if (getNextLex(t_iter)->GetToken() != constant_tk && !checkLexem(t_iter, id_tk)) {
-            printError(MUST_BE_ID, *t_iter);
-            return -EXIT_FAILURE;
-        }
-
-        tree->AddRightNode(var_iter->GetName());
-        tree->GetRightNode()->AddLeftNode("0");
-        var_iter = t_iter;
-        subTree = simplExprParse(var_iter, t_iter, tree->GetRightNode(), t_lvl);
-
-        break;
-    }
-    case opb_tk: {
-        t_lvl += 3;
-        expressionParse(t_iter, tree, t_lvl);
-        break;
-    }
-    case cpb_tk: {
-        if (getNextLex(t_iter)->GetToken() != semi_tk) {
-            t_lvl -= 3;;
-            t_iter = getPrevLex(iter);
-            lex_table.erase(getNextLex(iter));
-            getPrevLex(t_iter);
-            expressionParse(t_iter, tree, t_lvl);
-        }
-        else {
-            t_lvl -= 3;;
-            var_iter = getPrevLex(iter);
-            t_iter = var_iter;
-            getNextLex(iter);
-            lex_table.erase(iter);
-            simplExprParse(var_iter, t_iter, tree, t_lvl);
-        }
-        break;
-    }
-    case semi_tk: {
-        if (t_lvl > 0) {
-            printError(MUST_BE_BRACKET_END, *t_iter);
-            return -EXIT_FAILURE;
-        }
-        if (t_lvl < 0) {
-            printError(MUST_BE_BRACKET, *t_iter);
-            return -EXIT_FAILURE;
-        }
-        break;
-    }
-    case then_tk: {
-        return EXIT_SUCCESS;
-    }
-    default: {
-        printError(MUST_BE_ID, *t_iter);
-        return -EXIT_FAILURE;
-    }
-    }
-
-    return EXIT_SUCCESS;
-}
-
-Tree* Syntax::simplExprParse(const lex_it& var_iter, lex_it& t_iter, Tree* tree, int t_lvl)
-{
-    Tree* subTree;
-    auto iter = getNextLex(t_iter);
-    switch (iter->GetToken()) {
-    case plus_tk:
-    case minus_tk:
-    case mul_tk:
-    case div_tk:
-    case bool_eqv_tk:
-    case bool_noneqv_tk:
-    case bool_bigger_tk:
-    case bool_less_tk:
-    case bool_bigeqv_tk:
-    case bool_leseqv_tk:{
-        if (operations.at(iter->GetName()) + t_lvl <= (tree->GetPriority())) {    // Priority of current <=
-            tree->AddRightNode(var_iter->GetName());
-            subTree = tree->GetParentNode();
-
-            while (operations.at(iter->GetName()) + t_lvl <= operations.at(subTree->GetValue())) // go through parents
-                subTree = subTree->GetParentNode();
-
-            subTree = createLowestOpTree(subTree, iter->GetName(), operations.at(iter->GetName()) + t_lvl);
-        }
-        else { // if Priority of current >
-         /******* Create a new node of subexpression ************/
-            tree->AddRightNode(iter->GetName(), operations.at(iter->GetName()) + t_lvl);   //     <oper> <- subTree
-            subTree = tree->GetRightNode();                                                //      /  /
-            subTree->AddLeftNode(var_iter->GetName());                                     //    val  nullptr
-         /********************************************************/
-        }
-        expressionParse(t_iter, subTree, t_lvl);
-        break;
-    }
-    default: { // any other lexem, expression is over
-        if (iter->GetToken() == cpb_tk) {
-            getPrevLex(t_iter);
-            expressionParse(t_iter, tree, t_lvl);
-        }
-        else {
-            if (t_lvl != 0)
-            {
-                getPrevLex(t_iter);
-                expressionParse(t_iter, tree, t_lvl);
-            }
-            tree->AddRightNode(var_iter->GetName());
-        }
-        break;
-    }
-    }
-    return tree;
-}
-
-Tree* Syntax::simplExprParse(Tree* var_tree, lex_it& t_iter, Tree* tree, int t_lvl)
-{
-    Tree* subTree;
-    auto iter = getNextLex(t_iter);
-    switch (iter->GetToken()) {
-    case plus_tk:
-    case minus_tk:
-    case mul_tk:
-    case div_tk:
-    case comp_tk: {
-        if (operations.at(iter->GetName()) + t_lvl <= (tree->GetPriority())) {    // Priority of current <=
-            tree->AddRightTree(var_tree);
-            subTree = tree->GetParentNode();
-
-            while (operations.at(iter->GetName()) + t_lvl <= operations.at(subTree->GetValue())) // go through parents
-                subTree = subTree->GetParentNode();
-
-            subTree = createLowestOpTree(subTree, iter->GetName(), operations.at(iter->GetName()) + t_lvl);
-        }
-        else { // if Priority of current >
-         /******* Create a new node of subexpression ************/
-            tree->AddRightNode(iter->GetName(), operations.at(iter->GetName()) + t_lvl);   //     <oper> <- subTree
-            subTree = tree->GetRightNode();                                                //      /  /
-            subTree->AddLeftTree(var_tree);                                     //    val  nullptr
-         /********************************************************/
-        }
-        expressionParse(t_iter, subTree, t_lvl);
-        break;
-    }
-    default: { // any other lexem, expression is over
-        if (iter->GetToken() == cpb_tk) {
-            getPrevLex(t_iter);
-            expressionParse(t_iter, tree, t_lvl);
-        }
-        else {
-            if (t_lvl != 0)
-            {
-                getPrevLex(t_iter);
-                expressionParse(t_iter, tree, t_lvl);
-            }
-            tree->AddRightTree(var_tree);
-        }
-        break;
-    }
-    }
-    return tree;
-}
-
-
-
-void Syntax::printError(errors t_err, Lexem lex) {
-    error = true;
-    switch (t_err) {
-    case UNKNOWN_LEXEM: {
-        std::cerr << "<E> Lexer: Get unknown lexem '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case EOF_ERR: {
-        std::cerr << "<E> Syntax: Premature end of file" << std::endl;
-        break;
-    }
-    case MUST_BE_ID: {
-        std::cerr << "<E> Syntax: Must be identifier instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_SEMI: {
-        std::cerr << "<E> Syntax: Must be ';' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_PROG: {
-        std::cerr << "<E> Syntax: Program must start from lexem 'program' ("
-            << lex.GetLine() << ")" << std::endl;
-        break;
-    }
-    case MUST_BE_COMMA: {
-        std::cerr << "<E> Syntax: Must be ',' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_CONST: {
-        std::cerr << "<E> Syntax: Must be constant in square brackets on"
-            << lex.GetLine() << "line" << std::endl;
-        break;
-    }
-    case MUST_BE_COMP: {
-        std::cerr << "<E> Syntax: Must be comparison sign on "
-            << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case DUPL_ID_ERR: {
-        std::cerr << "<E> Syntax: Duplicate identifier '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case UNKNOWN_ID: {
-        std::cerr << "<E> Syntax: Undefined variable '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_DOT: {
-        std::cerr << "<E> Syntax: Program must be end by '.'" << std::endl;
-        break;
-    }
-    case MUST_BE_DOTS_ARR: {
-        std::cerr << "<E> Syntax: Invalid array range definition, must be '..' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_BRACKET: {
-        std::cerr << "<E> Syntax: Missing '(' in expression on " 
-            << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_BRACKET_END: {
-        std::cerr << "<E> Syntax: Must be ')' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_ARRBRACKET: {
-        std::cerr << "<E> Syntax: Must be '[' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_ARRBRACKET_END: {
-        std::cerr << "<E> Syntax: Must be ']' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_DO: {
-        std::cerr << "<E> Syntax: Must be 'do' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_TO: {
-        std::cerr << "<E> Syntax: Must be 'to' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_THEN: {
-        std::cerr << "<E> Syntax: Must be 'then' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_OF: {
-        std::cerr << "<E> Syntax: Must be 'of' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_TYPE: {
-        std::cerr << "<E> Syntax: Must be type instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case MUST_BE_ASS: {
-        std::cerr << "<E> Syntax: Must be ':=' instead '" << lex.GetName()
-            << "' on " << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-    case INCORRECT_TYPE: {
-        std::cerr << "<E> Syntax: Identifier is not an array"
-            << " on " << lex.GetLine() << " line " << std::endl;
-        break;
-    }
-    case INCORRECT_RANGE: {
-        std::cerr << "<E> Syntax: Out of array range on "
-            << lex.GetLine() << " line" << std::endl;
-        break;
-    }
-                    // TODO: Add remaining error types
-    default: {
-        std::cerr << "<E> Syntax: Undefined type of error" << std::endl;
-        break;
-    }
-    }
-}
-
-bool Syntax::checkLexem(const lex_it& t_iter, const tokens& t_tok) {
-    if (t_iter == lex_table.end())   return false;
-    if (t_iter->GetToken() != t_tok) return false;
-
-    return true;
-}
-
-bool Syntax::isVarExist(const std::string& t_var_name) {
-    auto map_iter = id_map.find(t_var_name);
-    return !(map_iter == id_map.end());
-}
-
-void Syntax::updateVarTypes(const std::list<std::string>& t_var_list, const std::string& t_type_name) {
-    try {
-        for (auto& el : t_var_list)
-            id_map.at(el).type = t_type_name;
-    }
-    catch (const std::exception & exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-            << exp.what() << std::endl;
-    }
-}
-
-void Syntax::updateVarTypes(const std::list<std::string>& t_var_list, const std::string& t_type_name,
-                                const std::pair<int, int>& range) {
-    try {
-        for (auto& el : t_var_list) {
-            id_map.at(el).type = t_type_name;
-            id_map.at(el).isarray = true;
-            id_map.at(el).range.first = range.first;
-            id_map.at(el).range.second = range.second;
-        }
-    }
-    catch (const std::exception& exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-                  << exp.what() << std::endl;
-    }
-}
-
-void Syntax::buildVarTree(const std::list<std::string>& t_var_list, Tree* t_tree) {
-    try {
-        auto i = 0;
-        for (auto& el : t_var_list) {
-            auto* tmp_tree = Tree::CreateNode(el);
-            tmp_tree->AddRightNode(id_map.at(el).type);
-            createVarTree(t_tree, tmp_tree, i++);
-        }
-    }
-    catch (const std::exception & exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-            << exp.what() << std::endl;
-    }
-}
-
-void Syntax::buildVarTree(const std::list<std::string>& t_var_list, Tree* t_tree, Tree* array_tree) {
-    try {
-        auto i = 0;
-        
-        for (auto& el : t_var_list) {
-            auto* tmp_tree = Tree::CreateNode(el);
-            tmp_tree->AddRightTree(array_tree);
-            array_tree->AddRightNode(id_map.at(el).type, 0);
-            createVarTree(t_tree, tmp_tree, i++);
-        }
-    }
-    catch (const std::exception& exp) {
-        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
-                  << exp.what() << std::endl;
-    }
-}
-
-
-
-void Syntax::createVarTree(Tree* t_tree, Tree* t_donor_tree, int lvl) {
-    if (lvl > 0) {
-        lvl--;
-        createVarTree(t_tree->GetRightNode(), t_donor_tree, lvl);
-    }
-    else {
-        t_tree->AddLeftTree(t_donor_tree);
-        t_tree->AddRightNode("$");
-    }
-}
-
-Tree* Syntax::createLowestOpTree(Tree* t_parent_tree, std::string value, int priority_) {
-    auto* lowest_tree = Tree::CreateNode(t_parent_tree, value, priority_);
-    lowest_tree->AddLeftTree(t_parent_tree->GetRightNode());
-    t_parent_tree->AddRightTree(lowest_tree);
-
-    return lowest_tree;
-}
-
-
+#include "Syntax.h"
+
+
+Syntax::Syntax(TokenTable&& t_lex_table) {
+    if (t_lex_table.empty())
+        throw std::runtime_error("<E> Syntax: Lexemes table is empty");
+    if (t_lex_table.GetToken(0) == eof_tk)
+        throw std::runtime_error("<E> Syntax: Code file is empty");
+    lex_table = std::move(t_lex_table);
+    cursor = lex_table.begin();
+}
+
+Syntax::~Syntax() = default; // nodes are released with the arena
+
+
+Tree* Syntax::ParseCode() {
+    TreeArena::Scope scope(*arena);
+    auto first_node = arena->GetNodeCount();
+
+    if (!lex_table.IsStreaming())
+        std::cout << "Code contains " << lex_table.size() << " lexemes" << std::endl;
+    auto& it = cursor;
+    if (programParse(it) != 0)
+        return nullptr;
+
+    while (it != lex_table.end() && it->GetToken() != eof_tk)
+        blockParse(it);
+
+    if (!error) {
+        std::cout << std::endl;
+        std::cout << std::setfill('*') << std::setw(50);
+        std::cout << "\r\n";
+
+        root_tree->PrintTree(0);
+    }
+    
+    std::cout << "EOF" << std::endl;
+    if (lex_table.IsStreaming())
+        std::cout << "Code contains " << lex_table.size() << " lexemes" << std::endl;
+    std::cout << "Tree takes " << arena->GetNodeCount() - first_node << " nodes, arena uses "
+        << arena->GetUsedBytes() << " of " << arena->GetBytes() << " bytes" << std::endl;
+
+    return root_tree;
+}
+
+/**
+ * @brief Parse code after an edit, statements of the main compound which are out
+ *        of the edit are copied from the tree of the last parse to the arena of
+ *        this one, so the last parse can be released
+ * @param[in] t_prev   - syntax of the code before the edit
+ * @param[in] t_damage - lexemes changed by the edit
+ *
+ * @return root of the syntax tree
+ */
+Tree* Syntax::ParseCode(Syntax& t_prev, const TokenDamage& t_damage) {
+    if (t_damage.first > t_prev.body_first) { // declarations are the same
+        prev = &t_prev;
+        damage = t_damage;
+    }
+
+    auto* tree = ParseCode();
+    prev = nullptr;
+    return tree;
+}
+
+Syntax::lex_it Syntax::getNextLex(lex_it& iter) {
+    if (iter != lex_table.end())
+        iter++;
+
+    return iter;
+}
+
+Syntax::lex_it Syntax::getPrevLex(lex_it& iter) {
+    if (iter != lex_table.begin())
+        iter--;
+
+    return iter;
+}
+
+Syntax::lex_it Syntax::peekLex(int N, lex_it t_iter) {
+    if (N >= lex_table.end() - t_iter)
+        return lex_table.end();
+
+    return t_iter + N;
+}
+
+Syntax::lex_it Syntax::peekPrevLex(int N, lex_it t_iter) {
+    if (N > t_iter - lex_table.begin())
+        return lex_table.begin();
+
+    return t_iter - N;
+}
+
+int Syntax::programParse(lex_it &t_iter) {
+    if (!checkLexem(t_iter, program_tk)) {
+        printError(MUST_BE_PROG, *t_iter);
+        return -EXIT_FAILURE;
+    }
+
+    auto iter = getNextLex(t_iter);
+
+    if (!checkLexem(iter, id_tk)) {
+        if (iter->GetToken() == eof_tk) {
+            printError(EOF_ERR, *iter);
+            return -EXIT_FAILURE;
+        }
+        else {
+            printError(MUST_BE_ID, *iter);
+            return -EXIT_FAILURE;
+        }
+    }
+
+    auto root_name = iter->GetName(); // save the name of program
+
+    iter = getNextLex(t_iter);
+
+    if (!checkLexem(iter, semi_tk)) {
+        if (iter->GetToken() == eof_tk) {
+            printError(EOF_ERR, *iter);
+            return -EXIT_FAILURE;
+        }
+        else {
+            printError(MUST_BE_SEMI, *iter);
+            return -EXIT_FAILURE;
+        }
+    } 
+        root_tree = Tree::CreateNode(NodeKind::program, root_name);
+
+    return EXIT_SUCCESS;
+}
+
+int Syntax::blockParse(lex_it& t_iter) {
+    try {
+        auto iter = getNextLex(t_iter);
+        switch (iter->GetToken()) {
+        case var_tk: {
+            root_tree->AddLeftNode(NodeKind::var_list, "var");
+            vardpParse(t_iter, root_tree->GetLeftNode()); 
+            break;
+        }
+        case begin_tk: {
+            root_tree->AddRightTree(compoundParse(t_iter, 0));
+            break;
+        }
+        case dot_tk: {
+            if (!error) std::cout << "Program was parse successfully" << std::endl;
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+    catch (const std::exception & exp) {
+        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
+            << exp.what() << std::endl;
+        return -EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+std::list<symbol_t> Syntax::vardParse(lex_it& t_iter) {
+    std::list<symbol_t> var_list;
+    do {
+        auto iter = getNextLex(t_iter);
+        if (!checkLexem(iter, id_tk)) {
+            printError(MUST_BE_ID, *iter);
+            return var_list;
+        }
+
+        if (symbols.Declare(iter->GetSymbol()) == nullptr) printError(DUPL_ID_ERR, *iter);
+
+        var_list.push_back(t_iter->GetSymbol());
+        getNextLex(t_iter);
+    } while (checkLexem(t_iter, comma_tk));
+
+    return var_list;
+}
+
+int Syntax::vardpParse(lex_it& t_iter, Tree *t_tree) {
+    for (;;) {
+        auto var_list = vardParse(t_iter);
+        auto* tree_value = Tree::CreateNode(NodeKind::array_type, "");
+        bool isArray{ false };
+
+        if (!checkLexem(t_iter, ddt_tk)) {
+            printError(MUST_BE_COMMA, *t_iter);
+        }
+
+        auto type_iter = getNextLex(t_iter);
+
+        if (t_iter->GetToken() == arr_tk) {
+            tree_value->ChangeValue(t_iter->GetName());
+            tree_value->AddLeftNode(NodeKind::range, "range");
+            getNextLex(t_iter);
+
+            if (!checkLexem(t_iter, osb_tk)) {
+                printError(MUST_BE_ARRBRACKET, *t_iter);
+            }
+
+            getNextLex(t_iter);
+
+            if (!checkLexem(t_iter, constant_tk)) {
+                printError(MUST_BE_ID, *t_iter);
+            }
+
+            tree_value->GetLeftNode()->AddLeftNode(NodeKind::constant, t_iter->GetName());
+            getNextLex(t_iter);
+
+            if (!checkLexem(t_iter, dots_arr_tk)) {
+                printError(MUST_BE_DOTS_ARR, *t_iter);
+            }
+
+            getNextLex(t_iter);
+      
+            if (!checkLexem(t_iter, constant_tk)) {
+                printError(MUST_BE_ID, *t_iter);
+            }
+
+            tree_value->GetLeftNode()->AddRightNode(NodeKind::constant, t_iter->GetName());
+            getNextLex(t_iter);
+
+            if (!checkLexem(t_iter, csb_tk)) {
+                printError(MUST_BE_ARRBRACKET_END, *t_iter);
+            }
+
+            getNextLex(t_iter);
+
+            if (!checkLexem(t_iter, of_tk)) {
+                printError(MUST_BE_OF, *t_iter);
+            }
+
+            type_iter = getNextLex(t_iter);
+            isArray = true;
+        }
+
+
+        if (!checkLexem(t_iter, type_tk)) {
+            printError(MUST_BE_TYPE, *t_iter);
+        }
+
+        getNextLex(t_iter);
+        if (!checkLexem(t_iter, semi_tk)) {
+            printError(MUST_BE_SEMI, *t_iter);
+        }
+    
+        if (isArray) {
+            std::pair<int, int> range = { tree_value->GetLeftNode()->GetLeftNode()->GetNumber(),
+                                            tree_value->GetLeftNode()->GetRightNode()->GetNumber() };
+            updateVarTypes(var_list, type_iter->GetName(), range);
+        }
+        else {
+            updateVarTypes(var_list, type_iter->GetName());
+        }
+
+        if (isArray) {
+            while (t_tree->GetLeftNode() != nullptr)
+                t_tree = t_tree->GetRightNode();
+            buildVarTree(var_list, t_tree, tree_value);
+        }
+        else {
+            if (t_tree->GetKind() == NodeKind::var_list) {
+                while (t_tree->GetLeftNode() != nullptr)
+                    t_tree = t_tree->GetRightNode();
+                buildVarTree(var_list, t_tree);
+            }
+            else {
+                while (t_tree->GetLeftNode() != nullptr)
+                    t_tree = t_tree->GetRightNode();
+                buildVarTree(var_list, t_tree);
+            }
+        }
+
+    
+        if (checkLexem(peekLex(1, t_iter), id_tk) || checkLexem(peekLex(1, t_iter), var_tk)) {
+            if (checkLexem(peekLex(1, t_iter), var_tk))
+                getNextLex(t_iter);
+            t_tree = t_tree->GetRightNode(); // next declaration
+            continue;
+        }
+
+        return EXIT_SUCCESS; // list ends with empty '$'
+    }
+}
+
+/**
+ * @brief Parse assignment like 'a := ...' or 'arr[i + 1] := ...'
+ * @param[inout] t_iter - identifier of variable, moves to the lexeme which ends expression
+ *
+ * @return tree of assignment or nullptr on error
+ */
+Tree* Syntax::assignParse(lex_it& t_iter) {
+    if (!isVarExist(t_iter->GetSymbol())) {
+        printError(UNKNOWN_ID, *t_iter);
+        return nullptr;
+    }
+
+    auto* target = Tree::CreateNode(NodeKind::id, t_iter->GetName());
+    if (checkLexem(peekLex(1, t_iter), osb_tk)) {
+        target = elementParse(t_iter);
+        if (target == nullptr)
+            return nullptr;
+
+        auto* index = binaryParse(t_iter);
+        if (index == nullptr)
+            return nullptr;
+        target->AddRightTree(index);
+
+        if (!checkLexem(getNextLex(t_iter), csb_tk)) {
+            printError(MUST_BE_ARRBRACKET_END, *t_iter);
+            return nullptr;
+        }
+        if (!isInRange(target)) {
+            printError(INCORRECT_RANGE, *t_iter);
+            return nullptr;
+        }
+    }
+
+    getNextLex(t_iter);
+    if (!checkLexem(t_iter, ass_tk)) {
+        printError(MUST_BE_ASS, *t_iter);
+        return nullptr;
+    }
+
+    auto* tree_exp = Tree::CreateNode(NodeKind::assign, t_iter->GetName());
+    tree_exp->AddLeftTree(target);
+
+
+    expressionParse(t_iter, tree_exp);
+
+    if (!checkLexem(t_iter, semi_tk) && (checkLexem(peekLex(1, t_iter), to_tk))
+                                     && (checkLexem(peekLex(1, t_iter), downto_tk))) { // we exit from expression on the ';'
+        printError(MUST_BE_SEMI, *t_iter);
+        return nullptr;
+    }
+
+    return tree_exp;
+}
+
+/**
+ * @brief Parse statement up to the next nested statement of it
+ * @param[inout] t_frame - invocation of statement, it's resumed from its stage
+ * @param[out]   t_call  - nested statement or compound to parse before the next step
+ *
+ * @return true if statement is parsed, its tree is in t_frame.result
+ */
+bool Syntax::stateParse(ParseFrame& t_frame, ParseFrame& t_call) {
+    auto& t_iter = t_frame.iter;
+    auto& var_iter = t_frame.var_iter;
+    auto c_count = t_frame.c_count;
+
+    for (;;) {
+        switch (t_frame.stage) {
+        case ParseFrame::start: {
+            auto iter = getNextLex(t_iter);
+            switch (iter->GetToken()) {
+            case id_tk:
+                return t_frame.Finish(assignParse(t_iter));
+            case begin_tk:
+                return t_frame.Call(t_call, true, t_iter, c_count, ParseFrame::after_begin);
+            case if_tk: {
+                auto* tree_exp = Tree::CreateNode(NodeKind::if_op, t_iter->GetName());
+                expressionParse(t_iter, tree_exp);
+
+                if (tree_exp->GetRightNode() == nullptr) { return t_frame.Finish(nullptr); };
+
+                auto* cond = tree_exp->GetRightNode();
+                if (!isCondition(cond)) {
+                    printError(MUST_BE_COMP, *t_iter);
+                    return t_frame.Finish(nullptr);
+                }
+
+
+                tree_exp->AddLeftTree(tree_exp->GetRightNode());
+                if (t_iter->GetToken() != then_tk) {
+                    printError(MUST_BE_THEN, *t_iter);
+                    return t_frame.Finish(nullptr);
+                }
+
+                tree_exp->AddRightNode(NodeKind::then_op, "then");
+                auto then_exp = tree_exp->GetRightNode();
+                var_iter = getNextLex(t_iter);
+                t_frame.tree = tree_exp;
+                t_frame.node = then_exp;
+
+                if (var_iter->GetToken() == break_tk) {
+                    then_exp->AddLeftNode(NodeKind::break_op, "break");
+                    then_exp->GetLeftNode()->AddRightNode(NodeKind::label, breakpoint);
+                    getNextLex(var_iter);
+                }
+
+                if ((var_iter->GetToken() == id_tk) || (var_iter->GetToken() == begin_tk)
+                    || (var_iter->GetToken() == for_tk) || (var_iter->GetToken() == if_tk)) {
+                    var_iter = getPrevLex(var_iter);
+                    return t_frame.Call(t_call, false, var_iter, c_count, ParseFrame::after_then);
+                }
+                t_frame.stage = ParseFrame::else_part;
+                continue;
+            }
+            case for_tk: {
+                t_frame.tree = Tree::CreateNode(NodeKind::for_op, t_iter->GetName());
+                return t_frame.Call(t_call, false, t_iter, 0, ParseFrame::after_for_init);
+            }
+            default:
+                return t_frame.Finish(nullptr);
+            }
+        }
+        case ParseFrame::after_begin: {
+            t_iter = t_frame.nested_iter;
+            if (!checkLexem(peekLex(1, t_iter), semi_tk)) {
+                printError(MUST_BE_SEMI, *t_iter);
+                return t_frame.Finish(nullptr);
+            }
+            else getNextLex(t_iter);
+
+            return t_frame.Finish(t_frame.nested);
+        }
+        case ParseFrame::after_then: {
+            var_iter = t_frame.nested_iter;
+            if (t_frame.nested == nullptr)
+                return t_frame.Finish(nullptr);
+            t_frame.node->AddLeftTree(t_frame.nested);
+            t_frame.stage = ParseFrame::else_part;
+            continue;
+        }
+        case ParseFrame::else_part: {
+            // var_iter is the lexeme which ends the 'then' statement, 'else'
+            // may be this lexeme or the next one after ';'
+            auto then_exp = t_frame.node;
+            if (var_iter->GetToken() != else_tk && checkLexem(peekLex(1, var_iter), else_tk))
+                getNextLex(var_iter);
+            if (var_iter->GetToken() != else_tk) { // 'if' ends with its 'then' statement
+                t_iter = var_iter;
+                return t_frame.Finish(t_frame.tree);
+            }
+
+            then_exp->AddRightNode(NodeKind::else_op, "else");
+            getNextLex(var_iter);
+
+            if (var_iter->GetToken() == break_tk) {
+                then_exp->GetRightNode()->AddLeftNode(NodeKind::break_op, "break");
+                then_exp->GetRightNode()->GetLeftNode()->AddRightNode(NodeKind::label, breakpoint);
+                getNextLex(var_iter);
+            }
+            else if ((var_iter->GetToken() == id_tk) || (var_iter->GetToken() == begin_tk)
+                || (var_iter->GetToken() == for_tk) || (var_iter->GetToken() == if_tk)) {
+                var_iter = getPrevLex(var_iter);
+                return t_frame.Call(t_call, false, var_iter, c_count, ParseFrame::after_else);
+            }
+            t_iter = var_iter;
+            return t_frame.Finish(t_frame.tree);
+        }
+        case ParseFrame::after_else: {
+            if (t_frame.nested == nullptr)
+                return t_frame.Finish(nullptr);
+            t_frame.node->GetRightNode()->AddLeftTree(t_frame.nested);
+            t_iter = t_frame.nested_iter;
+            return t_frame.Finish(t_frame.tree);
+        }
+        case ParseFrame::after_for_init: {
+            t_iter = t_frame.nested_iter;
+            auto* tree_exp = t_frame.tree;
+            if (t_frame.nested == nullptr)
+                return t_frame.Finish(nullptr);
+
+            if ((!checkLexem(t_iter, to_tk)) && (!checkLexem(t_iter, downto_tk))) {
+                printError(MUST_BE_TO, *t_iter);
+                return t_frame.Finish(nullptr);
+            }
+
+            auto* tree_to = Tree::CreateNode(checkLexem(t_iter, to_tk) ? NodeKind::to : NodeKind::downto,
+                                            t_iter->GetName());
+            tree_to->AddLeftTree(t_frame.nested);
+            tree_exp->AddLeftTree(tree_to);
+
+            expressionParse(t_iter, tree_exp->GetLeftNode());
+
+            if (t_iter->GetToken() != do_tk) {
+                printError(MUST_BE_DO, *t_iter);
+                return t_frame.Finish(nullptr);
+            }
+
+            var_iter = getNextLex(t_iter);
+
+            if ((var_iter->GetToken() != id_tk) && (var_iter->GetToken() != begin_tk)) {
+                printError(MUST_BE_ID, *t_iter);
+                return t_frame.Finish(nullptr);
+            }
+
+            var_iter = getPrevLex(var_iter);
+            return t_frame.Call(t_call, false, var_iter, c_count, ParseFrame::after_for_body);
+        }
+        case ParseFrame::after_for_body: {
+            if (t_frame.nested == nullptr)
+                return t_frame.Finish(nullptr);
+            t_frame.tree->AddRightTree(t_frame.nested);
+            t_iter = t_frame.nested_iter;
+            return t_frame.Finish(t_frame.tree);
+        }
+        default:
+            return t_frame.Finish(nullptr);
+        }
+    }
+}
+
+/**
+ * @brief Parse compound with all statements nested in it. Invocations of
+ *        stateParse() and compoundParse() wait on an explicit stack instead
+ *        of the call stack
+ * @param[inout] t_iter  - 'begin' of compound, moves to its 'end'
+ * @param[in]    c_count - level of the enclosing compound
+ *
+ * @return tree of compound or nullptr on error
+ */
+Tree* Syntax::compoundParse(lex_it& t_iter, int c_count) {
+    std::vector<ParseFrame> stack(1);
+    stack.back().compound = true;
+    stack.back().iter = t_iter;
+    stack.back().c_count = c_count;
+
+    for (;;) {
+        ParseFrame call;
+        auto& frame = stack.back();
+        bool done = frame.compound ? compoundParse(frame, call) : stateParse(frame, call);
+        if (!done) {
+            stack.push_back(std::move(call));
+            continue;
+        }
+
+        auto* result = frame.result;
+        auto iter = frame.iter;
+        stack.pop_back();
+        if (stack.empty()) {
+            t_iter = iter;
+            return result;
+        }
+        stack.back().nested = result;
+        stack.back().nested_iter = iter;
+    }
+}
+
+/**
+ * @brief Parse compound up to the next statement which isn't taken from the
+ *        last parse
+ * @param[inout] t_frame - invocation of compound, it's resumed from its stage
+ * @param[out]   t_call  - statement to parse before the next step
+ *
+ * @return true if compound is parsed, its tree is in t_frame.result
+ */
+bool Syntax::compoundParse(ParseFrame& t_frame, ParseFrame& t_call) {
+    auto& t_iter = t_frame.iter;
+
+    auto label = [&]() -> std::string {
+        return "_op" + std::to_string(t_frame.c_count) + "." +
+            std::to_string(t_frame.sec_prm);
+    };
+
+    auto is_end = [&]() -> bool {
+        return (checkLexem(peekLex(1, t_iter), end_tk)
+            || checkLexem(peekLex(1, t_iter), eof_tk));
+    };
+
+    auto add_statement = [&](Tree* subTree) {
+        if (subTree == nullptr)
+            return;
+        auto*& tree = t_frame.node;
+        tree->AddRightNode(NodeKind::statement, label());
+        tree->GetRightNode()->AddLeftTree(subTree);
+        tree = tree->GetRightNode();
+
+        if (t_frame.c_count == 1 && !error && !lex_table.IsStreaming())
+            statements.push_back({ t_frame.first, t_iter->GetOffset(), peekLex(1, t_iter)->GetOffset(),
+                                   tree, t_frame.break_in, breakpoint });
+
+        if (!is_end()) t_frame.sec_prm++;
+    };
+
+    if (t_frame.stage == ParseFrame::start) {
+        t_frame.c_count++; // level of this compound
+        t_frame.tree = Tree::CreateNode(NodeKind::compound, t_iter->GetName()); // 'begin' node
+        t_frame.node = t_frame.tree;
+        if (t_frame.c_count == 1)
+            body_first = t_iter->GetOffset();
+    }
+    else { // after_statement
+        t_iter = t_frame.nested_iter;
+        add_statement(t_frame.nested);
+    }
+    auto c_count = t_frame.c_count;
+
+    while (t_iter->GetToken() != end_tk) {
+        if (t_iter->GetToken() == eof_tk) {
+            printError(EOF_ERR, *t_iter);
+            return t_frame.Finish(nullptr);
+        }
+        if (t_iter->GetToken() != dot_tk)
+        {
+            if (checkLexem(peekLex(1, t_iter), for_tk)) { breakpoint = label(); };
+            t_frame.first = t_iter->GetOffset();
+            t_frame.break_in = breakpoint;
+
+            Tree *subTree = (c_count == 1) ? reuseStatement(t_iter) : nullptr;
+            if (subTree == nullptr)
+                return t_frame.Call(t_call, false, t_iter, c_count, ParseFrame::after_statement);
+            add_statement(subTree);
+        }
+        else break;
+    }
+    
+    auto* tree = t_frame.node;
+    if (c_count == 1) {
+        if (checkLexem(peekLex(1, t_iter), unknown_tk) ||
+            checkLexem(peekLex(1, t_iter), eof_tk) ||
+            !checkLexem(peekLex(1, t_iter), dot_tk)) {
+            printError(MUST_BE_DOT, *t_iter);
+            return t_frame.Finish(nullptr);
+        }
+        tree->AddRightNode(NodeKind::end_program, std::string(t_iter->GetName()) + ".");
+    } else
+        tree->AddRightNode(NodeKind::end, t_iter->GetName());
+    return t_frame.Finish(t_frame.tree);
+}
+
+/**
+ * @brief Take the statement from the tree of the last parse if its lexemes
+ *        weren't changed
+ * @param[inout] t_iter - lexeme in front of the statement, moves to its last lexeme
+ *
+ * @return subtree of the statement or nullptr if it must be parsed again
+ */
+Tree* Syntax::reuseStatement(lex_it& t_iter) {
+    if (prev == nullptr)
+        return nullptr;
+
+    auto first = t_iter->GetOffset();
+    bool before_edit = first < damage.first;
+    int64_t shift = 0; // new offset - old offset
+    if (!before_edit) {
+        if (first < damage.new_end)
+            return nullptr; // inside of the edit
+        shift = static_cast<int64_t>(damage.new_end) - damage.old_end;
+    }
+
+    auto& old = prev->statements;
+    auto old_first = static_cast<uint32_t>(first - shift);
+    auto st = std::lower_bound(old.begin(), old.end(), old_first,
+        [](const Statement& t_st, uint32_t t_offset) { return t_st.first < t_offset; });
+    if (st == old.end() || st->first != old_first || st->label == nullptr)
+        return nullptr;
+
+    // parser looks one lexeme past the statement, it must be out of the edit too
+    if (before_edit && st->next >= damage.first)
+        return nullptr;
+    if (st->break_in != breakpoint)
+        return nullptr;
+
+    auto* tree = Tree::CopyTree(st->label->GetLeftNode(), reused_nodes);
+    st->label = nullptr;
+    if (tree == nullptr)
+        return nullptr;
+
+    t_iter = lex_table.begin() + static_cast<std::ptrdiff_t>(lex_table.FindOffset(static_cast<uint32_t>(st->last + shift)));
+    breakpoint = st->break_out;
+    return tree;
+}
+
+/**
+ * @brief Parse expression and add it as the right node of the tree
+ * @param[inout] t_iter - lexeme in front of expression, moves to the lexeme
+ *                        which ends it (';', 'then', 'to', 'do'...)
+ * @param[in]    tree   - parent node of expression
+ *
+ * @return EXIT_SUCCESS or -EXIT_FAILURE
+ */
+int Syntax::expressionParse(lex_it& t_iter, Tree *tree) {
+    auto* expr_tree = binaryParse(t_iter);
+    if (expr_tree == nullptr)
+        return -EXIT_FAILURE;
+
+    tree->AddRightTree(expr_tree);
+
+    if (getNextLex(t_iter)->GetToken() == cpb_tk) {
+        printError(MUST_BE_BRACKET, *t_iter);
+        return -EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Parse expression by the shunting-yard algorithm: parsed operands and
+ *        waiting operators, brackets and unary minuses are kept on explicit
+ *        stacks, so nesting of expression isn't limited by the call stack
+ * @param[inout] t_iter - lexeme in front of expression, moves to its last lexeme
+ *
+ * @return tree of expression or nullptr on error
+ */
+Tree* Syntax::binaryParse(lex_it& t_iter) {
+    struct Pending {
+        const Operator*	op;		// binary operator, nullptr for '(', '[' and unary minus
+        bool			minus;	// unary minus, like -3 it is 0 - 3
+        Tree*			element;	// array element of '[', the index is its right node
+    };
+    std::vector<Tree*> operands;
+    std::vector<Pending> pending;
+    size_t brackets = 0;
+
+    auto reduce = [&]() {
+        auto top = pending.back();
+        pending.pop_back();
+        auto* right = operands.back();
+        operands.pop_back();
+
+        Tree* op_tree = nullptr;
+        if (top.minus) {
+            op_tree = Tree::CreateNode(*FindOperator(minus_tk));
+            op_tree->AddLeftNode(NodeKind::constant, "0");
+        }
+        else {
+            op_tree = Tree::CreateNode(*top.op);
+            op_tree->AddLeftTree(operands.back());
+            operands.pop_back();
+        }
+        op_tree->AddRightTree(right);
+        operands.push_back(op_tree);
+    };
+
+    for (;;) {
+        // operand, it can be preceded by unary minuses and '('
+        auto iter = getNextLex(t_iter);
+        while (checkLexem(iter, minus_tk) || checkLexem(iter, opb_tk)) {
+            if (checkLexem(iter, opb_tk)) brackets++;
+            pending.push_back({ nullptr, checkLexem(iter, minus_tk), nullptr });
+            iter = getNextLex(t_iter);
+        }
+
+        // index of array element is parsed like an expression in brackets
+        if (checkLexem(iter, id_tk) && checkLexem(peekLex(1, t_iter), osb_tk)) {
+            auto* element = elementParse(t_iter);
+            if (element == nullptr)
+                return nullptr;
+            pending.push_back({ nullptr, false, element });
+            brackets++;
+            continue;
+        }
+
+        auto* operand = operandParse(t_iter);
+        if (operand == nullptr)
+            return nullptr;
+        operands.push_back(operand);
+
+        // unary minuses and brackets closed after the operand
+        const Operator* op = nullptr;
+        for (;;) {
+            while (!pending.empty() && pending.back().minus)
+                reduce();
+
+            op = FindOperator(peekLex(1, t_iter)->GetToken());
+            if (op != nullptr || brackets == 0)
+                break;
+
+            getNextLex(t_iter);
+            while (pending.back().op != nullptr)
+                reduce();
+            auto* element = pending.back().element;
+            pending.pop_back(); // '(' or '['
+            brackets--;
+            if (element == nullptr) {
+                if (!checkLexem(t_iter, cpb_tk)) {
+                    printError(MUST_BE_BRACKET_END, *t_iter);
+                    return nullptr;
+                }
+                continue;
+            }
+
+            if (!checkLexem(t_iter, csb_tk)) {
+                printError(MUST_BE_ARRBRACKET_END, *t_iter);
+                return nullptr;
+            }
+            element->AddRightTree(operands.back());
+            operands.back() = element;
+            if (!isInRange(element)) {
+                printError(INCORRECT_RANGE, *t_iter);
+                return nullptr;
+            }
+        }
+
+        if (op == nullptr)
+            break;
+
+        // operators of the same or higher priority are left associative
+        while (!pending.empty() && pending.back().op != nullptr &&
+               pending.back().op->priority >= op->priority)
+            reduce();
+        pending.push_back({ op, false, nullptr });
+        getNextLex(t_iter);
+    }
+
+    while (!pending.empty())
+        reduce();
+    return operands.back();
+}
+
+/**
+ * @brief Parse operand: identifier, constant or boolean value, array elements
+ *        are parsed by binaryParse()
+ * @param[inout] t_iter - first lexeme of operand, moves to its last lexeme
+ *
+ * @return tree of operand or nullptr on error
+ */
+Tree* Syntax::operandParse(lex_it& t_iter) {
+    auto iter = t_iter;
+    switch (iter->GetToken()) {
+    case id_tk: {
+        if (!isVarExist(iter->GetSymbol()))
+            printError(UNKNOWN_ID, *t_iter);
+        return Tree::CreateNode(NodeKind::id, iter->GetName());
+    }
+    case constant_tk:
+    case bool_true_tk:
+    case bool_false_tk: {
+        return Tree::CreateNode(checkLexem(iter, constant_tk) ? NodeKind::constant : NodeKind::boolean,
+                                iter->GetName());
+    }
+    default: {
+        printError(MUST_BE_ID, *t_iter);
+        return nullptr;
+    }
+    }
+}
+
+/**
+ * @brief Parse array in front of '[' of its element
+ * @param[inout] t_iter - identifier of array, moves to '['
+ *
+ * @return array element without index or nullptr if it isn't an array
+ */
+Tree* Syntax::elementParse(lex_it& t_iter) {
+    auto* var = symbols.Find(t_iter->GetSymbol());
+    if (var == nullptr || !var->isarray) {
+        printError((var == nullptr) ? UNKNOWN_ID : INCORRECT_TYPE, *t_iter);
+        return nullptr;
+    }
+
+    auto* element = Tree::CreateNode(NodeKind::array_elem, "array");
+    element->AddLeftNode(NodeKind::id, t_iter->GetName());
+    getNextLex(t_iter);
+    return element;
+}
+
+
+
+void Syntax::printError(errors t_err, Lexem lex) {
+    error = true;
+    switch (t_err) {
+    case UNKNOWN_LEXEM: {
+        std::cerr << "<E> Lexer: Get unknown lexem '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case EOF_ERR: {
+        std::cerr << "<E> Syntax: Premature end of file" << std::endl;
+        break;
+    }
+    case MUST_BE_ID: {
+        std::cerr << "<E> Syntax: Must be identifier instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_SEMI: {
+        std::cerr << "<E> Syntax: Must be ';' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_PROG: {
+        std::cerr << "<E> Syntax: Program must start from lexem 'program' ("
+            << lex.GetLine() << ")" << std::endl;
+        break;
+    }
+    case MUST_BE_COMMA: {
+        std::cerr << "<E> Syntax: Must be ',' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_CONST: {
+        std::cerr << "<E> Syntax: Must be constant in square brackets on"
+            << lex.GetLine() << "line" << std::endl;
+        break;
+    }
+    case MUST_BE_COMP: {
+        std::cerr << "<E> Syntax: Must be comparison sign on "
+            << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case DUPL_ID_ERR: {
+        std::cerr << "<E> Syntax: Duplicate identifier '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case UNKNOWN_ID: {
+        std::cerr << "<E> Syntax: Undefined variable '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_DOT: {
+        std::cerr << "<E> Syntax: Program must be end by '.'" << std::endl;
+        break;
+    }
+    case MUST_BE_DOTS_ARR: {
+        std::cerr << "<E> Syntax: Invalid array range definition, must be '..' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_BRACKET: {
+        std::cerr << "<E> Syntax: Missing '(' in expression on " 
+            << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_BRACKET_END: {
+        std::cerr << "<E> Syntax: Must be ')' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_ARRBRACKET: {
+        std::cerr << "<E> Syntax: Must be '[' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_ARRBRACKET_END: {
+        std::cerr << "<E> Syntax: Must be ']' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_DO: {
+        std::cerr << "<E> Syntax: Must be 'do' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_TO: {
+        std::cerr << "<E> Syntax: Must be 'to' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_THEN: {
+        std::cerr << "<E> Syntax: Must be 'then' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_OF: {
+        std::cerr << "<E> Syntax: Must be 'of' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_TYPE: {
+        std::cerr << "<E> Syntax: Must be type instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case MUST_BE_ASS: {
+        std::cerr << "<E> Syntax: Must be ':=' instead '" << lex.GetName()
+            << "' on " << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+    case INCORRECT_TYPE: {
+        std::cerr << "<E> Syntax: Identifier is not an array"
+            << " on " << lex.GetLine() << " line " << std::endl;
+        break;
+    }
+    case INCORRECT_RANGE: {
+        std::cerr << "<E> Syntax: Out of array range on "
+            << lex.GetLine() << " line" << std::endl;
+        break;
+    }
+                    // TODO: Add remaining error types
+    default: {
+        std::cerr << "<E> Syntax: Undefined type of error" << std::endl;
+        break;
+    }
+    }
+}
+
+bool Syntax::checkLexem(const lex_it& t_iter, const tokens& t_tok) {
+    if (t_iter == lex_table.end())   return false;
+    if (t_iter->GetToken() != t_tok) return false;
+
+    return true;
+}
+
+bool Syntax::isVarExist(symbol_t t_var_name) {
+    return symbols.Find(t_var_name) != nullptr;
+}
+
+/**
+ * @brief Check constant index of array element by the range of array, other
+ *        indices are known at run time only
+ * @param[in] t_element - array element with index
+ *
+ * @return false if the constant is out of range
+ */
+bool Syntax::isInRange(Tree* t_element) {
+    auto* index = t_element->GetRightNode();
+    if (index->GetKind() != NodeKind::constant)
+        return true;
+
+    auto* var = symbols.Find(t_element->GetLeftNode()->GetSymbol());
+    auto number = index->GetNumber();
+    return number >= var->range.first && number <= var->range.second;
+}
+
+/**
+ * @brief Check condition of if: comparison, boolean value, variable or array
+ *        element, or 'and', 'or', 'xor' of conditions
+ * @param[in] t_cond - root of condition
+ *
+ * @return true if it's a condition
+ * @note Operands of 'and', 'or' and 'xor' wait on an explicit stack
+ */
+bool Syntax::isCondition(Tree* t_cond) {
+    std::vector<Tree*> pending{ t_cond };
+    while (!pending.empty()) {
+        auto* node = pending.back();
+        pending.pop_back();
+        if (node == nullptr)
+            return false;
+
+        switch (node->GetKind()) {
+        case NodeKind::boolean:
+            continue;
+        case NodeKind::array_elem:
+            node = node->GetLeftNode();
+            [[fallthrough]];
+        case NodeKind::id: {
+            auto* var = symbols.Find(node->GetSymbol());
+            if (var == nullptr || var->type != VarType::boolean)
+                return false;
+            continue;
+        }
+        case NodeKind::operation:
+            break;
+        default:
+            return false;
+        }
+
+        auto op = node->GetOperation();
+        if (IsComparison(op))
+            continue;
+        if (op != OpKind::and_ && op != OpKind::or_ && op != OpKind::xor_)
+            return false;
+        pending.push_back(node->GetLeftNode());
+        pending.push_back(node->GetRightNode());
+    }
+    return true;
+}
+
+
+void Syntax::updateVarTypes(const std::list<symbol_t>& t_var_list, std::string_view t_type_name) {
+    try {
+        for (auto& el : t_var_list)
+            symbols.At(el).type = ToVarType(t_type_name);
+    }
+    catch (const std::exception & exp) {
+        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
+            << exp.what() << std::endl;
+    }
+}
+
+void Syntax::updateVarTypes(const std::list<symbol_t>& t_var_list, std::string_view t_type_name,
+                                const std::pair<int, int>& range) {
+    try {
+        for (auto& el : t_var_list) {
+            auto& var = symbols.At(el);
+            var.type = ToVarType(t_type_name);
+            var.isarray = true;
+            var.range = range;
+        }
+    }
+    catch (const std::exception& exp) {
+        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
+                  << exp.what() << std::endl;
+    }
+}
+
+void Syntax::buildVarTree(const std::list<symbol_t>& t_var_list, Tree* t_tree) {
+    try {
+        auto i = 0;
+        for (auto& el : t_var_list) {
+            auto* tmp_tree = Tree::CreateNode(NodeKind::variable, Interner::Get().GetName(el));
+            tmp_tree->AddRightNode(NodeKind::type, GetTypeName(symbols.At(el).type));
+            createVarTree(t_tree, tmp_tree, i++);
+        }
+    }
+    catch (const std::exception & exp) {
+        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
+            << exp.what() << std::endl;
+    }
+}
+
+void Syntax::buildVarTree(const std::list<symbol_t>& t_var_list, Tree* t_tree, Tree* array_tree) {
+    try {
+        auto i = 0;
+        
+        for (auto& el : t_var_list) {
+            auto* tmp_tree = Tree::CreateNode(NodeKind::variable, Interner::Get().GetName(el));
+            tmp_tree->AddRightTree(array_tree);
+            array_tree->AddRightNode(NodeKind::type, GetTypeName(symbols.At(el).type), 0);
+            createVarTree(t_tree, tmp_tree, i++);
+        }
+    }
+    catch (const std::exception& exp) {
+        std::cerr << "<E> Syntax: Catch exception in " << __func__ << ": "
+                  << exp.what() << std::endl;
+    }
+}
+
+
+
+void Syntax::createVarTree(Tree* t_tree, Tree* t_donor_tree, int lvl) {
+    for (; lvl > 0; lvl--)
+        t_tree = t_tree->GetRightNode();
+
+    t_tree->AddLeftTree(t_donor_tree);
+    t_tree->AddRightNode(NodeKind::var_list, "$");
+}
+
+
@@ -1,65 +1,136 @@
-#ifndef SYNTAX_H
-#define SYNTAX_H
-#include <algorithm>
-#include <iostream>
-#include <chrono>
-#include <list>
-#include <map>
-#include <vector>
-#include "Lexem.h"
-#include "Variable.h"
-#include "Tree.h"
-
-class Syntax {
-public:
-	explicit Syntax(std::vector<Lexem> &&t_lex_table);
-	Tree* ParseCode(); // start fuction of code parsing 
-	~Syntax();
-private:
-	using lex_it = std::vector<Lexem>::iterator;
-	lex_it							cursor;
-	std::vector<Lexem>				lex_table;	// table of lexemes 
-	std::map<std::string, Variable> id_map;		// table of identifiers 
-	Tree							*root_tree;
-	bool							error{ false };
-	std::string						breakpoint;
-
-	std::map<std::string, int> operations;
-
-	lex_it		getNextLex(lex_it& iter);
-	lex_it		getPrevLex(lex_it& iter);
-
-	lex_it		peekLex(int N, lex_it t_iter);
-	lex_it		peekPrevLex(int N, lex_it t_iter);
-
-
-	int						programParse(lex_it &t_iter);
-	int						blockParse(lex_it& t_iter);
-
-	std::list<std::string>	vardParse(lex_it& t_iter);
-	int						vardpParse(lex_it& t_iter, Tree *t_tree);
-
-	Tree*					stateParse(lex_it& t_iter, int c_count);
-	Tree*					compoundParse(lex_it& t_iter, int c_count);
-
-	int						expressionParse(lex_it& t_iter, Tree* tree, int t_lvl);
-	Tree					*simplExprParse(const lex_it& var_iter, lex_it& t_iter, Tree* tree, int t_lvl);
-	Tree					*simplExprParse(Tree* var_tree, lex_it& t_iter, Tree* tree, int t_lvl);
-
-
-	void	printError(errors t_err, Lexem lex);
-	bool	checkLexem(const lex_it& t_iter, const tokens& t_tok);
-	bool	isVarExist(const std::string& t_var_name);
-	void	updateVarTypes(const std::list<std::string>& t_var_list, const std::string& t_type_name);
-	void	updateVarTypes(const std::list<std::string>& t_var_list, const std::string& t_type_name, const std::pair<int, int>& range);
-
-	void	buildVarTree(const std::list<std::string>& t_var_list, Tree* t_tree);
-	void    buildVarTree(const std::list<std::string>& t_var_list, Tree* t_tree, Tree* array_tree);
-	void	createVarTree(Tree* t_tree, Tree* t_donor_tree, int lvl);
-	Tree*	createLowestOpTree(Tree* t_parent_tree, std::string value, int priority);
-
-};
-
-
-#endif // !SYNTAX_H
-
+#ifndef SYNTAX_H
+#define SYNTAX_H
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <vector>
+#include "Operators.h"
+#include "TokenTable.h"
+#include "SymbolTable.h"
+#include "Tree.h"
+
+class Syntax {
+public:
+	// the parser looks back at most a few lexemes and one lexeme ahead
+	static constexpr size_t TOKEN_WINDOW = 16;
+
+	explicit Syntax(TokenTable &&t_lex_table);
+	Tree* ParseCode(); // start fuction of code parsing 
+	Tree* ParseCode(Syntax& t_prev, const TokenDamage& t_damage); // takes unchanged statements from the last parse
+	~Syntax();
+
+	const TokenTable&	GetLexTable() const { return lex_table; }
+	size_t				GetReusedNodes() const { return reused_nodes; }
+	const SymbolTable&	GetSymbols() const { return symbols; }
+	TreeArena&			GetArena() const { return *arena; }
+private:
+	using lex_it = TokenTable::iterator;
+
+	// statement of the main compound, it can be copied to the tree of the next
+	// parse. Lexemes are kept by their offsets in the source
+	struct Statement {
+		uint32_t		first;		// lexeme in front of the statement
+		uint32_t		last;		// last lexeme of the statement
+		uint32_t		next;		// lexeme after the statement, parser looks at it
+		Tree*			label;		// node with the statement as the left subtree
+		std::string		break_in;	// breakpoint before and after the statement
+		std::string		break_out;
+	};
+
+	// invocation of stateParse() or compoundParse(). Statements nested in
+	// compound, if and for are parsed by the frames pushed above it, so the
+	// depth of nesting is limited by the heap only
+	struct ParseFrame {
+		enum Stage : uint8_t {
+			start,
+			after_statement,	// compound: statement is parsed
+			after_begin,		// statement: nested compound is parsed
+			after_then,
+			else_part,
+			after_else,
+			after_for_init,
+			after_for_body,
+		};
+
+		bool			compound{ false };	// compoundParse() or stateParse()
+		Stage			stage{ start };
+		int				c_count{ 0 };		// level of compound
+		lex_it			iter;				// t_iter of invocation
+		lex_it			var_iter;			// lexeme of statement nested in if or for
+		Tree*			tree{ nullptr };	// compound, if or for node
+		Tree*			node{ nullptr };	// last statement of compound, 'then' of if
+		Tree*			result{ nullptr };
+		Tree*			nested{ nullptr };	// tree and last lexeme of the finished nested invocation
+		lex_it			nested_iter;
+		int				sec_prm{ 0 };		// number of statement in compound
+		uint32_t		first{ 0 };			// offset of lexeme in front of statement
+		std::string		break_in;			// breakpoint in front of statement
+
+		bool	Finish(Tree* t_result) { result = t_result; return true; }
+		bool	Call(ParseFrame& t_call, bool t_compound, lex_it t_iter, int t_count, Stage t_resume) {
+			t_call.compound = t_compound;
+			t_call.iter = t_iter;
+			t_call.c_count = t_count;
+			stage = t_resume;
+			return false;
+		}
+	};
+
+	std::unique_ptr<TreeArena>		arena{ std::make_unique<TreeArena>() };	// nodes of the tree
+	lex_it							cursor;
+	TokenTable						lex_table;	// table of lexemes 
+	SymbolTable						symbols;	// table of identifiers
+	Tree							*root_tree{ nullptr };
+	bool							error{ false };
+	std::string						breakpoint;
+
+	std::vector<Statement>			statements;
+	uint32_t						body_first{ UINT32_MAX };	// 'begin' of the main compound
+	Syntax							*prev{ nullptr };		// last parse while ParseCode(prev, damage)
+	TokenDamage						damage;
+	size_t							reused_nodes{ 0 };
+
+	lex_it		getNextLex(lex_it& iter);
+	lex_it		getPrevLex(lex_it& iter);
+
+	lex_it		peekLex(int N, lex_it t_iter);
+	lex_it		peekPrevLex(int N, lex_it t_iter);
+
+
+	int						programParse(lex_it &t_iter);
+	int						blockParse(lex_it& t_iter);
+
+	std::list<symbol_t>		vardParse(lex_it& t_iter);
+	int						vardpParse(lex_it& t_iter, Tree *t_tree);
+
+	Tree*					compoundParse(lex_it& t_iter, int c_count);
+	bool					compoundParse(ParseFrame& t_frame, ParseFrame& t_call);
+	bool					stateParse(ParseFrame& t_frame, ParseFrame& t_call);
+	Tree*					assignParse(lex_it& t_iter);
+	Tree*					reuseStatement(lex_it& t_iter);
+
+	int						expressionParse(lex_it& t_iter, Tree* tree);
+	Tree*					binaryParse(lex_it& t_iter);
+	Tree*					operandParse(lex_it& t_iter);
+	Tree*					elementParse(lex_it& t_iter);
+
+
+	void	printError(errors t_err, Lexem lex);
+	bool	checkLexem(const lex_it& t_iter, const tokens& t_tok);
+	bool	isVarExist(symbol_t t_var_name);
+	bool	isCondition(Tree* t_cond);
+	bool	isInRange(Tree* t_element);
+	void	updateVarTypes(const std::list<symbol_t>& t_var_list, std::string_view t_type_name);
+	void	updateVarTypes(const std::list<symbol_t>& t_var_list, std::string_view t_type_name, const std::pair<int, int>& range);
+
+	void	buildVarTree(const std::list<symbol_t>& t_var_list, Tree* t_tree);
+	void    buildVarTree(const std::list<symbol_t>& t_var_list, Tree* t_tree, Tree* array_tree);
+	void	createVarTree(Tree* t_tree, Tree* t_donor_tree, int lvl);
+
+};
+
+
+#endif // !SYNTAX_H
+
@@ -0,0 +1,84 @@
+#include "Target.h"
+
+using Operand = MachineCode::Operand;
+
+std::unique_ptr<Target> Target::Create(Kind t_kind) {
+    if (t_kind == Kind::x86_64)
+        return std::make_unique<TargetX64>();
+    return std::make_unique<TargetX86>();
+}
+
+
+void TargetX86::PutMemory(Emitter& t_out, std::string_view t_label, int t_offset) const {
+    t_out << t_label;
+    if (t_offset > 0)
+        t_out << " + " << t_offset;
+    else if (t_offset < 0)
+        t_out << " - " << -t_offset;
+}
+
+/**
+ * @brief Code section up to the first statement
+ * @param[out] t_code - code of program
+ *
+ * @return none
+ */
+void TargetX86::GetEntry(MachineCode& t_code) const {
+    t_code.AddDirective(".text");
+    t_code.AddDirective(".global _main");
+    t_code.AddSeparator();
+    t_code.AddLabel(Operand::MakeLabel(LabelKind::name, 0, t_code.AddName("_main")));
+    t_code.AddSeparator();
+}
+
+void TargetX86::GetExit(MachineCode& t_code) const {
+    t_code.AddSeparator();
+    t_code.Add(Opcode::leave);
+    t_code.Add(Opcode::ret);
+    t_code.AddDirective("");
+}
+
+
+void TargetX64::PutMemory(Emitter& t_out, std::string_view t_label, int t_offset) const {
+    t_out << t_label;
+    if (t_offset > 0)
+        t_out << "+";
+    if (t_offset != 0)
+        t_out << t_offset;
+    t_out << "(%rip)";
+}
+
+/**
+ * @brief Code section up to the first statement: prologue of 'main' saves %rbp
+ *        and registers of the caller which are used for temporaries
+ * @param[out] t_code - code of program
+ *
+ * @return none
+ * @note Return address and 6 saved registers take 56 bytes, 8 more keep
+ * %rsp aligned by 16
+ */
+void TargetX64::GetEntry(MachineCode& t_code) const {
+    t_code.AddDirective(".text");
+    t_code.AddDirective(".globl main");
+    t_code.AddDirective(".type main, @function");
+    t_code.AddSeparator();
+    t_code.AddLabel(Operand::MakeLabel(LabelKind::name, 0, t_code.AddName("main")));
+    t_code.Add(Opcode::push, Operand::MakeReg(ebp), {}, true);
+    t_code.Add(Opcode::mov, Operand::MakeReg(esp), Operand::MakeReg(ebp), true);
+    for (auto reg : { ebx, r12d, r13d, r14d, r15d })
+        t_code.Add(Opcode::push, Operand::MakeReg(reg), {}, true);
+    t_code.Add(Opcode::sub, Operand::MakeImm(8), Operand::MakeReg(esp), true);
+    t_code.AddSeparator();
+}
+
+void TargetX64::GetExit(MachineCode& t_code) const {
+    t_code.AddSeparator();
+    t_code.Add(Opcode::lea, Operand::MakeAddress(ebp, -40), Operand::MakeReg(esp), true);
+    for (auto reg : { r15d, r14d, r13d, r12d, ebx, ebp })
+        t_code.Add(Opcode::pop, Operand::MakeReg(reg), {}, true);
+    t_code.Add(Opcode::xor_, Operand::MakeReg(eax), Operand::MakeReg(eax));
+    t_code.Add(Opcode::ret);
+    t_code.AddDirective(".size main, .-main");
+    t_code.AddDirective(".section .note.GNU-stack,\"\",@progbits");
+    t_code.AddDirective("");
+}
@@ -0,0 +1,82 @@
+#ifndef TARGET_H
+#define TARGET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include "Emitter.h"
+#include "MachineCode.h"
+
+/*
+ * Machine of the generated code. GenCode builds 32-bit operations on registers
+ * by number, the target gives its registers, words of the stack, the entry and
+ * the exit of program, AsmPrinter asks it for names of registers and memory
+ * operands. Registers are numbered in the order of Reg, the target has the
+ * first GetRegCount() of them.
+ */
+class Target
+{
+public:
+	enum class Kind : uint8_t {
+		x86,		// 32-bit, '_main' without prologue
+		x86_64,		// System V, 'main' is linked by gcc
+	};
+
+	static std::unique_ptr<Target>	Create(Kind t_kind);
+	virtual ~Target() = default;
+
+	virtual size_t		GetRegCount() const = 0;
+	virtual bool		IsWide() const = 0;					// words of the stack are 64-bit
+	int					GetWordSize() const { return IsWide() ? 8 : 4; }
+	static std::string_view	GetRegName(Reg t_reg, bool t_wide) { return t_wide ? WIDE_NAMES[t_reg] : REG_NAMES[t_reg]; }
+	static std::string_view	GetByteName(Reg t_reg) { return BYTE_NAMES[t_reg]; }	// %sil and above are 64-bit only
+
+	virtual void		PutMemory(Emitter& t_out, std::string_view t_label, int t_offset) const = 0;	// variable
+
+	virtual void		GetEntry(MachineCode& t_code) const = 0;
+	virtual void		GetExit(MachineCode& t_code) const = 0;
+	virtual const char*	GetDataAlign() const = 0;				// directive before variable or nullptr
+
+private:
+	static constexpr std::string_view REG_NAMES[] = {
+		"%eax", "%ebx", "%esi", "%edi", "%edx", "%ecx",
+		"%r8d", "%r9d", "%r10d", "%r11d", "%r12d", "%r13d", "%r14d", "%r15d", "%esp", "%ebp" };
+	static constexpr std::string_view WIDE_NAMES[] = {
+		"%rax", "%rbx", "%rsi", "%rdi", "%rdx", "%rcx",
+		"%r8", "%r9", "%r10", "%r11", "%r12", "%r13", "%r14", "%r15", "%rsp", "%rbp" };
+	static constexpr std::string_view BYTE_NAMES[] = {
+		"%al", "%bl", "%sil", "%dil", "%dl", "%cl",
+		"%r8b", "%r9b", "%r10b", "%r11b", "%r12b", "%r13b", "%r14b", "%r15b", "%spl", "%bpl" };
+};
+
+// 32-bit code as it's linked with the test runtime, data is addressed by labels
+class TargetX86 : public Target
+{
+public:
+	size_t		GetRegCount() const override { return 6; }
+	bool		IsWide() const override { return false; }
+
+	void		PutMemory(Emitter& t_out, std::string_view t_label, int t_offset) const override;
+
+	void		GetEntry(MachineCode& t_code) const override;
+	void		GetExit(MachineCode& t_code) const override;
+	const char*	GetDataAlign() const override { return nullptr; }
+};
+
+// x86-64 System V: data is addressed relative to %rip, %rbx and %r12-%r15 are
+// saved by 'main', the stack stays aligned by 16 bytes
+class TargetX64 : public Target
+{
+public:
+	size_t		GetRegCount() const override { return 14; }
+	bool		IsWide() const override { return true; }
+
+	void		PutMemory(Emitter& t_out, std::string_view t_label, int t_offset) const override;
+
+	void		GetEntry(MachineCode& t_code) const override;
+	void		GetExit(MachineCode& t_code) const override;
+	const char*	GetDataAlign() const override { return ".balign 4"; }
+};
+
+#endif // !TARGET_H
@@ -0,0 +1,74 @@
+#include "TokenTable.h"
+#include "Lexer.h"
+
+static_assert(unknown_tk >= INT8_MIN && eof_tk <= INT8_MAX, "Tokens must fit in int8_t");
+
+TokenTable::TokenTable(Lexer& t_source, size_t t_window) {
+    size_t size = 1;
+    while (size < t_window) // ring of 2^n slots
+        size <<= 1;
+
+    kinds.resize(size);
+    symbols.resize(size);
+    offsets.resize(size);
+    lines.resize(size);
+
+    source = &t_source;
+    window = size;
+    mask = size - 1;
+    finished = false;
+}
+
+void TokenTable::Add(const Lexem& t_lex, uint32_t t_offset) {
+    kinds.push_back(static_cast<int8_t>(t_lex.GetToken()));
+    symbols.push_back(t_lex.GetSymbol());
+    offsets.push_back(t_offset);
+    lines.push_back(t_lex.GetLine());
+    count++;
+}
+
+void TokenTable::Reserve(size_t t_count) {
+    kinds.reserve(t_count);
+    symbols.reserve(t_count);
+    offsets.reserve(t_count);
+    lines.reserve(t_count);
+}
+
+/**
+ * @brief Find lexeme by its place in the source, lexemes are sorted by offsets
+ * @param[in] t_offset - offset in the source file
+ *
+ * @return index of the first lexeme at or after the offset, size() if none
+ */
+size_t TokenTable::FindOffset(uint32_t t_offset) const {
+    size_t lo = 0, hi = count;
+    while (lo < hi) {
+        auto mid = lo + (hi - lo) / 2;
+        if (GetOffset(mid) < t_offset) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Read lexemes from the lexer up to the index (or EOF)
+ * @param[in] t_idx - index of needed lexeme
+ *
+ * @return none
+ */
+void TokenTable::pull(size_t t_idx) const {
+    while (count <= t_idx && !finished) {
+        uint32_t offset = 0;
+        auto lex = source->NextLex(offset);
+        auto slot = count & mask;
+
+        kinds[slot] = static_cast<int8_t>(lex.GetToken());
+        symbols[slot] = lex.GetSymbol();
+        offsets[slot] = offset;
+        lines[slot] = lex.GetLine();
+        count++;
+
+        if (lex.GetToken() == eof_tk)
+            finished = true;
+    }
+}
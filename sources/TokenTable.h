@@ -0,0 +1,144 @@
+#ifndef TOKEN_TABLE_H
+#define TOKEN_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "Lexem.h"
+
+class Lexer;
+
+// lexemes changed by an edit of the source, by their offsets: lexemes before
+// 'first' are the same in both tables, old lexemes from 'old_end' are the new
+// ones from 'new_end'.
+struct TokenDamage {
+	uint32_t	first{ 0 };
+	uint32_t	old_end{ UINT32_MAX };
+	uint32_t	new_end{ UINT32_MAX };
+	size_t		reused{ 0 };	// lexemes copied from the old table
+};
+
+/*
+ * Table of lexemes stored as a structure of arrays: kinds, symbol ids, source
+ * offsets and lines live in separate contiguous vectors. Code that looks only
+ * at GetToken() touches one byte per lexeme. Tokens are addressed by index, so
+ * any lookahead is O(1).
+ *
+ * In the streaming mode the arrays are a ring buffer of a fixed size: lexemes
+ * are pulled from the Lexer on demand and only the last 'window' of them can be
+ * addressed. Reading past the end of the file gives the EOF lexeme.
+ */
+class TokenTable
+{
+public:
+	// view of one lexeme, every getter reads only its own array
+	class Ref {
+	public:
+		Ref(const TokenTable* t_table, size_t t_idx) : table(t_table), idx(t_idx) {};
+
+		tokens				GetToken() const { return table->GetToken(idx); }
+		symbol_t			GetSymbol() const { return table->GetSymbol(idx); }
+		int					GetLine() const { return table->GetLine(idx); }
+		uint32_t			GetOffset() const { return table->GetOffset(idx); }
+		std::string_view	GetName() const { return table->GetName(idx); }
+
+		const Ref*			operator->() const { return this; }
+
+	private:
+		const TokenTable*	table;
+		size_t				idx;
+	};
+
+	class iterator {
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type		= Lexem;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= Ref;
+		using reference			= Lexem;
+
+		iterator() = default;
+		iterator(const TokenTable* t_table, size_t t_idx) : table(t_table), idx(t_idx) {};
+
+		Lexem		operator*() const { return table->GetLexem(idx); }
+		Ref			operator->() const { return Ref(table, idx); }
+
+		iterator&	operator++() { idx++; return *this; }
+		iterator&	operator--() { idx--; return *this; }
+		iterator	operator++(int) { auto tmp = *this; idx++; return tmp; }
+		iterator	operator--(int) { auto tmp = *this; idx--; return tmp; }
+		iterator&	operator+=(difference_type n) { idx += n; return *this; }
+		iterator&	operator-=(difference_type n) { idx -= n; return *this; }
+		iterator	operator+(difference_type n) const { return iterator(table, idx + n); }
+		iterator	operator-(difference_type n) const { return iterator(table, idx - n); }
+
+		difference_type operator-(const iterator& other) const {
+			return static_cast<difference_type>(idx) - static_cast<difference_type>(other.idx);
+		}
+
+		bool		operator==(const iterator& other) const { return idx == other.idx; }
+		bool		operator!=(const iterator& other) const { return idx != other.idx; }
+		bool		operator<(const iterator& other) const { return idx < other.idx; }
+
+		size_t		GetIndex() const { return idx; }
+
+	private:
+		const TokenTable*	table{ nullptr };
+		size_t				idx{ 0 };
+	};
+
+	TokenTable() = default;
+	TokenTable(Lexer& t_source, size_t t_window);	// streaming mode
+
+	void		Add(const Lexem& t_lex, uint32_t t_offset);
+	void		Reserve(size_t t_count);
+	size_t		FindOffset(uint32_t t_offset) const;	// first lexeme at or after the source offset
+
+	size_t		size() const { return count; }			// lexemes read so far in the streaming mode
+	bool		empty() const { if (!finished) pull(0); return count == 0; }
+	iterator	begin() const { return iterator(this, 0); }
+	iterator	end() const { return iterator(this, finished ? count : OPEN_END); }
+	bool		IsStreaming() const { return source != nullptr; }
+
+	tokens				GetToken(size_t t_idx) const { return static_cast<tokens>(kinds[at(t_idx)]); }
+	symbol_t			GetSymbol(size_t t_idx) const { return symbols[at(t_idx)]; }
+	int					GetLine(size_t t_idx) const { return lines[at(t_idx)]; }
+	uint32_t			GetOffset(size_t t_idx) const { return offsets[at(t_idx)]; }
+	std::string_view	GetName(size_t t_idx) const { return GetLexem(t_idx).GetName(); }
+	Lexem				GetLexem(size_t t_idx) const {
+		auto slot = at(t_idx);
+		return Lexem(static_cast<tokens>(kinds[slot]), symbols[slot], lines[slot]);
+	}
+
+private:
+	static constexpr size_t OPEN_END = PTRDIFF_MAX;	// end() while EOF isn't read yet
+
+	mutable std::vector<int8_t>		kinds;		// tokens, fits in a byte
+	mutable std::vector<symbol_t>	symbols;
+	mutable std::vector<uint32_t>	offsets;	// offset of lexeme in the source file
+	mutable std::vector<int>		lines;
+
+	Lexer*					source{ nullptr };		// lexer of the streaming mode
+	size_t					window{ SIZE_MAX };		// addressable lexemes before the last one
+	size_t					mask{ SIZE_MAX };		// index -> slot of the arrays
+	mutable size_t			count{ 0 };				// lexemes in the table
+	mutable bool			finished{ true };		// EOF lexeme is in the table
+
+	void		pull(size_t t_idx) const;
+
+	// slot of lexeme in the arrays, pulls it from the lexer if needed
+	size_t		at(size_t t_idx) const {
+		if (t_idx >= count) {
+			if (!finished) pull(t_idx);
+			if (t_idx >= count) t_idx = count - 1; // past the end of file
+		}
+		if (count - t_idx > window)
+			throw std::out_of_range("<E> TokenTable: Lexeme has left the token window");
+
+		return t_idx & mask;
+	}
+};
+
+#endif // !TOKEN_TABLE_H
@@ -1,170 +1,203 @@
-#include "Tree.h"
-
-Tree::Tree()
-{
-	left	= nullptr;
-	right   = nullptr;
-	parent  = nullptr;
-	value   = "";
-	priority = 0;
-}
-Tree::Tree(const string& val)
-{
-	left	= nullptr;
-	right   = nullptr;
-	parent  = nullptr;
-	value   = val;
-	priority = 0;
-}
-Tree::~Tree()
-{
-	FreeTree();
-}
-
-void Tree::SetPriority(int priority_) {
-	priority = priority_;
-}
-int	 Tree::GetPriority() {
-	return priority;
-}
-
-
-void Tree::AddLeftNode(const string& val)
-{
-	this->left = CreateNode(this, val);
-}
-void Tree::AddRightNode(const string& val)
-{
-	this->right = CreateNode(this, val);
-}
-
-
-void Tree::AddLeftNode(const string& val, int priority_) {
-	this->left = CreateNode(this, val, priority_);
-}
-void Tree::AddRightNode(const string& val, int priority_) {
-	this->right = CreateNode(this, val, priority_);
-}
-
-
-void Tree::AddLeftTree(Tree* tree)
-{
-	tree->parent = this;
-	this->left = tree;
-}
-void Tree::AddRightTree(Tree* tree)
-{
-	tree->parent = this;
-	this->right = tree;
-}
-
-
-Tree* Tree::CreateNode(const string& val)
-{
-	auto* node = new Tree(val);
-	return node;
-}
-Tree* Tree::CreateNode(Tree* parent_tree, const string& val)
-{
-	auto* node = new Tree(val);
-	node->parent = addressof(*parent_tree);
-	return node;
-}
-Tree* Tree::CreateNode(Tree* parent_tree, const string& val, int& priority_) {
-	auto* node = new Tree(val);
-	node->parent = addressof(*parent_tree);
-	node->SetPriority(priority_);
-	return node;
-}
-
-
-void Tree::ChangeValue(const string& val)
-{
-	value = val;
-}
-string Tree::GetValue()
-{
-	return this->value;
-}
-
-
-Tree* Tree::GetLeftNode()
-{
-	return this->left;
-}
-Tree* Tree::GetRightNode()
-{
-	return this->right;
-}
-Tree* Tree::GetParentNode()
-{
-	return this->parent;
-}
-
-
-void Tree::FreeLeftNode()
-{
-	FreeTree(this->left);
-}
-void Tree::FreeRightNode()
-{
-	FreeTree(this->right);
-}
-void Tree::FreeTree(Tree*& t_tree)
-{
-	try
-	{
-		if (t_tree->left != nullptr) FreeTree(t_tree->left);
-		if (t_tree->right != nullptr) FreeTree(t_tree->right);
-		delete t_tree;
-		t_tree = nullptr;
-	}
-	catch (const std::exception& exp)
-	{
-		cerr << "<E> Tree: Catch exception in " << __func__ << ": "
-			<< exp.what() << endl;
-	}
-}
-void Tree::FreeTree()
-{
-	if (this->left != nullptr) this->left->FreeTree();
-	if (this->right != nullptr) this->right->FreeTree();
-	parent = nullptr;
-	value = "";
-}
-
-
-void Tree::PrintTree(int tab)
-{
-	for (auto i = 0; i < tab; i++) {
-		std::cout << "    ";
-	}
-	std::cout << this->value << std::endl;
-
-	if (this->left != nullptr) { this->left->PrintTree(tab + 1); }
-	else {
-		for (auto i = 0; i < tab + 1; i++) {
-			std::cout << "    ";
-		}
-		//std::cout << "NULL" << std::endl;
-		cout << endl;
-	};
-	if (this->right != nullptr) { this->right->PrintTree(tab + 1); }
-	else {
-		for (auto i = 0; i < tab + 1; i++) {
-			std::cout << "    ";
-		}
-		//std::cout << "NULL" << std::endl;
-		cout << endl;
-	}
-}
-void Tree::PrintTree_2()
-{
-	std::cout << this << "\t" << this->value
-		<< ((this->value.size() >= 4) ? "\t " : "\t\t ")
-		<< this->left
-		<< ((this->left == nullptr) ? "\t\t\t " : "\t ")
-		<< this->right << std::endl;
-	if (this->left != nullptr) this->left->PrintTree_2();
-	if (this->right != nullptr) this->right->PrintTree_2();
-}
\ No newline at end of file
+#include "Tree.h"
+
+Tree::Tree(NodeKind t_kind, string_view val)
+{
+	left	= nullptr;
+	right   = nullptr;
+	parent  = nullptr;
+	symbol  = Interner::Get().Intern(val);
+	number  = 0;
+	priority = 0;
+	kind    = t_kind;
+	op      = OpKind::none;
+	setNumber();
+}
+
+void Tree::SetPriority(int priority_) {
+	priority = priority_;
+}
+int	 Tree::GetPriority() {
+	return priority;
+}
+
+
+void Tree::AddLeftNode(NodeKind t_kind, string_view val)
+{
+	this->left = createNode(this, t_kind, val);
+}
+void Tree::AddRightNode(NodeKind t_kind, string_view val)
+{
+	this->right = createNode(this, t_kind, val);
+}
+
+
+void Tree::AddLeftNode(NodeKind t_kind, string_view val, int priority_) {
+	this->left = createNode(this, t_kind, val);
+	this->left->SetPriority(priority_);
+}
+void Tree::AddRightNode(NodeKind t_kind, string_view val, int priority_) {
+	this->right = createNode(this, t_kind, val);
+	this->right->SetPriority(priority_);
+}
+
+
+void Tree::AddLeftTree(Tree* tree)
+{
+	tree->parent = this;
+	this->left = tree;
+}
+void Tree::AddRightTree(Tree* tree)
+{
+	tree->parent = this;
+	this->right = tree;
+}
+
+
+Tree* Tree::CreateNode(NodeKind t_kind, string_view val)
+{
+	return TreeArena::Current().Create<Tree>(t_kind, val);
+}
+Tree* Tree::CreateNode(const Operator& t_op)
+{
+	auto* node = CreateNode(NodeKind::operation, t_op.name);
+	node->op = t_op.kind;
+	node->SetPriority(t_op.priority);
+	return node;
+}
+Tree* Tree::createNode(Tree* parent_tree, NodeKind t_kind, string_view val)
+{
+	auto* node = CreateNode(t_kind, val);
+	node->parent = parent_tree;
+	return node;
+}
+
+
+void Tree::ChangeValue(string_view val)
+{
+	symbol = Interner::Get().Intern(val);
+	setNumber();
+}
+
+// number of constant is read once here, code generation takes it as is
+void Tree::setNumber()
+{
+	if (kind == NodeKind::boolean)
+		number = (GetValue() == "true") ? 1 : 0;
+	else if (kind == NodeKind::constant) {
+		auto text = GetValue();
+		auto negative = !text.empty() && text[0] == '-'; // folded constant
+		uint32_t value = 0;
+		for (auto ch : text.substr(negative ? 1 : 0))
+			value = value * 10 + (ch - '0');
+		number = static_cast<int>(negative ? 0u - value : value);
+	}
+}
+
+
+Tree* Tree::GetLeftNode()
+{
+	return this->left;
+}
+Tree* Tree::GetRightNode()
+{
+	return this->right;
+}
+Tree* Tree::GetParentNode()
+{
+	return this->parent;
+}
+
+
+void Tree::FreeLeftNode()
+{
+	this->left = nullptr;
+}
+void Tree::FreeRightNode()
+{
+	this->right = nullptr;
+}
+// copies are taken from the current arena, the source may be in another one
+Tree* Tree::CopyTree(const Tree* t_tree, size_t& t_count)
+{
+	if (t_tree == nullptr)
+		return nullptr;
+
+	auto* root = TreeArena::Current().Create<Tree>(*t_tree);
+	root->parent = nullptr;
+	std::vector<Tree*> stack{ root };
+	while (!stack.empty()) {
+		auto* node = stack.back();
+		stack.pop_back();
+		t_count++;
+		for (auto* child : { &node->left, &node->right }) {
+			if (*child == nullptr)
+				continue;
+			*child = TreeArena::Current().Create<Tree>(**child);
+			(*child)->parent = node;
+			stack.push_back(*child);
+		}
+	}
+	return root;
+}
+
+size_t Tree::CountNodes(Tree* t_tree)
+{
+	size_t count = 0;
+	std::vector<Tree*> stack;
+	if (t_tree != nullptr) stack.push_back(t_tree);
+
+	while (!stack.empty()) {
+		auto* node = stack.back();
+		stack.pop_back();
+		count++;
+		if (node->left != nullptr) stack.push_back(node->left);
+		if (node->right != nullptr) stack.push_back(node->right);
+	}
+	return count;
+}
+
+
+// nodes are taken from an explicit stack, missing child is printed as an empty
+// line. Levels deeper than MAX_PRINT_TAB are printed with its indent, so the
+// dump of very deep tree stays linear in its size
+void Tree::PrintTree(int tab)
+{
+	auto indent = [](int t_tab) {
+		for (auto i = 0; i < std::min(t_tab, MAX_PRINT_TAB); i++) {
+			std::cout << "    ";
+		}
+	};
+
+	std::vector<std::pair<Tree*, int>> stack{ { this, tab } };
+	while (!stack.empty()) {
+		auto [node, level] = stack.back();
+		stack.pop_back();
+
+		indent(level);
+		if (node == nullptr) {
+			//std::cout << "NULL" << std::endl;
+			cout << endl;
+			continue;
+		}
+		std::cout << node->GetValue() << std::endl;
+
+		stack.emplace_back(node->right, level + 1);
+		stack.emplace_back(node->left, level + 1);
+	}
+}
+void Tree::PrintTree_2()
+{
+	std::vector<Tree*> stack{ this };
+	while (!stack.empty()) {
+		auto* node = stack.back();
+		stack.pop_back();
+
+		std::cout << node << "\t" << node->GetValue()
+			<< ((node->GetValue().size() >= 4) ? "\t " : "\t\t ")
+			<< node->left
+			<< ((node->left == nullptr) ? "\t\t\t " : "\t ")
+			<< node->right << std::endl;
+		if (node->right != nullptr) stack.push_back(node->right);
+		if (node->left != nullptr) stack.push_back(node->left);
+	}
+}
@@ -1,63 +1,111 @@
-#ifndef TREE_H
-#define TREE_H
-#include <cstdlib>
-#include <iostream>
-#include <typeinfo>
-#include <memory>
-#include <string>
-#include <queue>
-#include <utility>
-#include <iomanip>
-using namespace std;
-
-class Tree
-{
-public:
-	Tree();
-	explicit Tree(const string& val);
-	virtual ~Tree();
-
-	void		 SetPriority(int priority_);
-	int		     GetPriority();
-
-	void		 AddLeftNode(const string& val);
-	void		 AddRightNode(const string& val);
-
-	void		 AddLeftNode(const string& val, int priority_);
-	void		 AddRightNode(const string& val, int priority_);
-
-	void		 AddLeftTree(Tree* tree);
-	void		 AddRightTree(Tree* tree);
-
-	void		 ChangeValue(const string& val);
-	string		 GetValue();
-
-	static Tree* CreateNode(const string& val);
-	static Tree* CreateNode(Tree* parent_tree, const string& val);
-	static Tree* CreateNode(Tree* parent_tree, const string& val, int& priority_);
-
-	Tree*		 GetLeftNode();
-	Tree*		 GetRightNode();
-	Tree*		 GetParentNode();
-
-	void		 FreeLeftNode();
-	void		 FreeRightNode();
-	static void  FreeTree(Tree*& t_tree);
-
-	void		 PrintTree(int tab);
-	void		 PrintTree_2();
-
-
-private:
-	Tree* left;
-	Tree* right;
-	Tree* parent;
-	string value;
-	int priority;
-
-	void FreeTree();
-};
-
-
-
+#ifndef TREE_H
+#define TREE_H
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <typeinfo>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <iomanip>
+#include "Interner.h"
+#include "Operators.h"
+#include "TreeArena.h"
+using namespace std;
+
+enum class NodeKind : uint8_t {
+	program,		// root, name of program
+	var_list,		// 'var' and '$' links of declarations, left: variable
+	variable,		// declared name, right: type or array_type
+	type,			// 'integer' or 'boolean'
+	array_type,		// 'array', left: range, right: type
+	range,			// left: low bound, right: high bound
+	compound,		// 'begin', right: first statement
+	statement,		// label of statement, left: statement, right: next one
+	end,			// 'end' of compound
+	end_program,	// 'end.' of main compound
+	assign,			// ':=', left: id or array_elem, right: expression
+	if_op,			// left: condition, right: then_op
+	then_op,		// left: statement, right: else_op
+	else_op,		// left: statement
+	for_op,			// left: to or downto, right: statement
+	to,				// left: assign, right: expression
+	downto,
+	break_op,		// right: label
+	label,			// name of label in code
+	operation,		// binary operator, see GetOperation()
+	id,				// variable in statement
+	constant,		// see GetNumber()
+	boolean,		// 'true' or 'false', see GetNumber()
+	array_elem,		// 'array', left: id, right: index expression
+};
+
+/*
+ * Node of syntax tree. Nodes are made only by CreateNode() in the current
+ * TreeArena and are released with it, text of nodes is kept in the Interner.
+ * Code generation dispatches on the kind and reads the payload: the operator,
+ * the symbol id or the number.
+ */
+class Tree
+{
+public:
+	Tree(NodeKind t_kind, string_view val);
+
+	void		 SetPriority(int priority_);
+	int		     GetPriority();
+
+	void		 AddLeftNode(NodeKind t_kind, string_view val);
+	void		 AddRightNode(NodeKind t_kind, string_view val);
+
+	void		 AddLeftNode(NodeKind t_kind, string_view val, int priority_);
+	void		 AddRightNode(NodeKind t_kind, string_view val, int priority_);
+
+	void		 AddLeftTree(Tree* tree);
+	void		 AddRightTree(Tree* tree);
+
+	void		 ChangeValue(string_view val);
+	string_view	 GetValue() const { return Interner::Get().GetName(symbol); }
+
+	NodeKind	 GetKind() const { return kind; }
+	OpKind		 GetOperation() const { return op; }		// OpKind::none if not operation
+	symbol_t	 GetSymbol() const { return symbol; }
+	int			 GetNumber() const { return number; }
+
+	static Tree* CreateNode(NodeKind t_kind, string_view val);
+	static Tree* CreateNode(const Operator& t_op);
+
+	Tree*		 GetLeftNode();
+	Tree*		 GetRightNode();
+	Tree*		 GetParentNode();
+
+	void		 FreeLeftNode();		// drops subtree, nodes are kept by the arena
+	void		 FreeRightNode();
+	static size_t CountNodes(Tree* t_tree);
+	static Tree* CopyTree(const Tree* t_tree, size_t& t_count);	// to the current arena, adds copied nodes to t_count
+
+	static constexpr int MAX_PRINT_TAB = 64;
+
+	void		 PrintTree(int tab);
+	void		 PrintTree_2();
+
+
+private:
+	Tree* left;
+	Tree* right;
+	Tree* parent;
+	symbol_t symbol;	// interned text
+	int number;			// value of constant or boolean
+	int priority;
+	NodeKind kind;
+	OpKind op;
+
+	static Tree* createNode(Tree* parent_tree, NodeKind t_kind, string_view val);
+	void		 setNumber();
+};
+
+
+
 #endif
\ No newline at end of file
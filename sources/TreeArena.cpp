@@ -0,0 +1,32 @@
+#include "TreeArena.h"
+
+thread_local TreeArena* TreeArena::current = nullptr;
+
+TreeArena& TreeArena::Current() {
+    static TreeArena global; // nodes made outside of any Scope
+    return (current != nullptr) ? *current : global;
+}
+
+/**
+ * @brief Take memory from the current chunk, start a new one if it's full
+ * @param[in] t_size  - size of object
+ * @param[in] t_align - alignment of object, power of 2
+ *
+ * @return pointer to memory of object
+ */
+void* TreeArena::allocate(size_t t_size, size_t t_align) {
+    auto pad = (t_align - reinterpret_cast<uintptr_t>(chunk_pos) % t_align) % t_align;
+    if (chunk_pos == nullptr || pad + t_size > chunk_left) {
+        auto size = std::max(CHUNK_SIZE, t_size + t_align);
+        chunks.emplace_back(new char[size]);
+        chunk_pos = chunks.back().get();
+        chunk_left = size;
+        arena_bytes += size;
+        pad = (t_align - reinterpret_cast<uintptr_t>(chunk_pos) % t_align) % t_align;
+    }
+
+    auto* mem = chunk_pos + pad;
+    chunk_pos += pad + t_size;
+    chunk_left -= pad + t_size;
+    return mem;
+}
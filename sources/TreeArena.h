@@ -0,0 +1,68 @@
+#ifndef TREE_ARENA_H
+#define TREE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Bump arena for nodes of a syntax tree. Nodes are placed one after another in
+ * chunks in the order they are created and are never freed one by one: all of
+ * them go away at once with the arena. Only trivially destructible objects can
+ * live here, nothing is run for them on release.
+ *
+ * Tree::CreateNode() takes nodes from the current arena, which is set by a Scope
+ * for the time of parsing.
+ */
+class TreeArena
+{
+public:
+	TreeArena() = default;
+	TreeArena(const TreeArena&) = delete;
+	TreeArena& operator=(const TreeArena&) = delete;
+
+	template<class T, class... Args>
+	T*			Create(Args&&... t_args) {
+		static_assert(std::is_trivially_destructible<T>::value, "TreeArena doesn't run destructors");
+		node_count++;
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(t_args)...);
+	}
+
+	size_t		GetNodeCount() const { return node_count; }
+	size_t		GetBytes() const { return arena_bytes; }	// size of all chunks
+	size_t		GetUsedBytes() const { return arena_bytes - chunk_left; }
+
+	static TreeArena&	Current();	// arena of the innermost Scope or the process-wide one
+
+	// makes the arena current until the end of the scope
+	class Scope {
+	public:
+		explicit Scope(TreeArena& t_arena) : outer(current) { current = &t_arena; }
+		~Scope() { current = outer; }
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		TreeArena*	outer;
+	};
+
+private:
+	static constexpr size_t CHUNK_SIZE = 32 * 1024;
+
+	std::vector<std::unique_ptr<char[]>>	chunks;
+	char*									chunk_pos{ nullptr };
+	size_t									chunk_left{ 0 };
+	size_t									arena_bytes{ 0 };
+	size_t									node_count{ 0 };
+
+	static thread_local TreeArena*			current;
+
+	void*		allocate(size_t t_size, size_t t_align);
+};
+
+#endif // !TREE_ARENA_H
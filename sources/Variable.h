@@ -1,17 +1,48 @@
-#ifndef VARIABLE_H
-#define VARIABLE_H
-
-#include <string>
-
-class Variable {
-public:
-	explicit Variable(const std::string& t_type, const std::string& t_value) : type(t_type), value(t_value) {};
-	~Variable() = default;
-	std::string type;
-	std::string value;
-	bool isarray{ false };
-	std::pair<int, int> range;
-};
-
-#endif // !VARIABLE_H
-
+#ifndef VARIABLE_H
+#define VARIABLE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Interner.h"
+
+enum class VarType : uint8_t {
+	unknown,
+	integer,
+	boolean,
+};
+
+enum class Storage : uint8_t {
+	bss,		// not initialized, '.space' in '.bss'
+	data,		// initialized, '.long' or '.byte' in '.data'
+};
+
+class Variable {
+public:
+	explicit Variable(symbol_t t_name) : name(t_name), label(Interner::Get().GetName(t_name)) {};
+	~Variable() = default;
+	symbol_t name;
+	VarType type{ VarType::unknown };
+	Storage storage{ Storage::bss };
+	bool isarray{ false };
+	std::pair<int, int> range;
+	std::string label;				// name in assembler code
+	int scope{ 0 };					// depth of scope with declaration
+	uint32_t outer{ UINT32_MAX };	// declaration of the same name hidden by this one
+};
+
+inline VarType ToVarType(std::string_view t_name) {
+	if (t_name == "integer") return VarType::integer;
+	if (t_name == "boolean") return VarType::boolean;
+	return VarType::unknown;
+}
+
+inline std::string_view GetTypeName(VarType t_type) {
+	switch (t_type) {
+	case VarType::integer: return "integer";
+	case VarType::boolean: return "boolean";
+	default:               return "?";
+	}
+}
+
+#endif // !VARIABLE_H
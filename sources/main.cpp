@@ -2,9 +2,37 @@
 #include "Course_project.h"
 
 
-int main() {
+int main(int argc, char* argv[]) {
 	std::cout << "I see this as an absolute win (it works)" << std::endl;
-	Compile("test.p");
+
+	std::string file_path = "test.p";
+	CompileOptions options;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--stream") options.streaming = true;
+		else if (arg == "-O0" || arg == "-O1" || arg == "-O2") options.opt_level = arg[2] - '0';
+		else if (arg == "-m32") options.target = Target::Kind::x86;
+		else if (arg == "-m64") options.target = Target::Kind::x86_64;
+		else if (arg == "--bounds-check") options.bounds_check = true;
+		else if (arg == "--edit" && i + 1 < argc) {
+			// --edit OFFSET:LENGTH:TEXT, rebuild after replacing LENGTH bytes at OFFSET
+			std::string edit = argv[++i];
+			auto first = edit.find(':');
+			auto second = edit.find(':', first + 1);
+			if (first == std::string::npos || second == std::string::npos) {
+				std::cerr << "<E> Wrong edit '" << edit << "'" << std::endl;
+				return 1;
+			}
+			TextEdit text_edit;
+			text_edit.offset = static_cast<uint32_t>(std::stoul(edit.substr(0, first)));
+			text_edit.removed = static_cast<uint32_t>(std::stoul(edit.substr(first + 1, second - first - 1)));
+			text_edit.text = edit.substr(second + 1);
+			options.edits.push_back(std::move(text_edit));
+		}
+		else file_path = arg;
+	}
+
+	Compile(file_path, options);
 
 	return 0;
 }
@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+"""Write a program with one construct nested DEPTH times.
+
+usage: gen_deep.py FORM DEPTH OUT
+"""
+import sys
+
+HEADER = "program deep;\nvar\n\tx, y, i: integer;\nbegin\n"
+
+
+def body(form, n):
+    if form == "begin":
+        return "begin\n" * n + "x := 1;\n" + "end;\n" * n + "y := 2;\n"
+    if form == "if":        # the innermost 'then' statement is the last one of the program
+        return "if x > y then\n" * n + "x := 1;\n"
+    if form == "ifbegin":
+        return "if x > y then begin\n" * n + "x := 1;\n" + "end;\n" * n + "x := 2;\n"
+    if form == "ifelse":
+        return "if x > y then x := 1 else\n" * n + "x := 2;\n" + "y := 2;\n"
+    if form == "for":
+        return "for i := 1 to 2 do begin\n" * n + "x := x + 1;\n" + "end;\n" * n
+    if form == "paren":
+        return "x := " + "(" * n + "y" + ")" * n + ";\n"
+    if form == "minus":
+        return "x := " + "-" * n + "y;\n"
+    if form == "lexpr":
+        return "x := y" + " + y" * n + ";\n"
+    if form == "rexpr":
+        return "x := y" + " + (y" * n + ")" * n + ";\n"
+    raise SystemExit("unknown form " + form)
+
+
+def main():
+    form, depth, out = sys.argv[1], int(sys.argv[2]), sys.argv[3]
+    with open(out, "w") as f:
+        f.write(HEADER + body(form, depth) + "end.\n")
+
+
+if __name__ == "__main__":
+    main()
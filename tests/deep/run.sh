@@ -0,0 +1,44 @@
+#!/bin/bash
+# Deep nesting stress test: every construct nested DEPTH (100000) times
+# must compile without errors.
+#
+# usage: tests/deep/run.sh [COMPILER] [DEPTH]
+#
+# Without COMPILER the compiler is built from sources/ with g++.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+depth=${2:-100000}
+
+pc=$1
+if [ -z "$pc" ]; then
+    pc="$work/pc"
+    ${CXX:-g++} -std=c++17 -O2 "$repo"/sources/*.cpp -o "$pc"
+fi
+pc=$(cd "$(dirname "$pc")" && pwd)/$(basename "$pc")
+
+failed=0
+for form in begin if ifbegin ifelse for paren minus lexpr rexpr; do
+    dir="$work/$form"
+    mkdir -p "$dir"
+    python3 "$here/gen_deep.py" "$form" "$depth" "$dir/test.p"
+
+    start=$(date +%s%N)
+    set +e
+    (cd "$dir" && "$pc" > out.txt 2> err.txt)
+    rc=$?
+    set -e
+    ms=$((($(date +%s%N) - start) / 1000000))
+
+    if [ $rc -ne 0 ] || grep -q '<E>\|Error' "$dir/out.txt" "$dir/err.txt" || [ ! -s "$dir/deep.S" ]; then
+        printf '%-8s FAIL rc=%d\n' "$form" $rc
+        grep -h '<E>\|Error' "$dir/out.txt" "$dir/err.txt" | head -3
+        failed=1
+    else
+        printf '%-8s ok   %d.%03d s\n' "$form" $((ms / 1000)) $((ms % 1000))
+    fi
+done
+exit $failed
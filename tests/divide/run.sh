@@ -0,0 +1,84 @@
+#!/bin/bash
+# Division by a constant: for every 32-bit dividend the quotient of the
+# strength-reduced sequence (magic number, shifts) must be the one of idivl.
+#
+# usage: tests/divide/run.sh [COMPILER] [DIVISOR...]
+#
+# Without COMPILER the compiler is built from sources/ with g++. The program
+# is compiled at -O2 for the 32-bit target, linked with as/ld and run, so
+# it needs binutils with i386 support. A divisor takes about 15 s.
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+repo=$(cd "$here/../.." && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+pc=$1
+[ $# -gt 0 ] && shift
+if [ -z "$pc" ]; then
+    pc="$work/pc"
+    ${CXX:-g++} -std=c++17 -O2 "$repo"/sources/*.cpp -o "$pc"
+fi
+pc=$(cd "$(dirname "$pc")" && pwd)/$(basename "$pc")
+divisors=${*:-3 7 -7 10 641 1000000007}
+
+# _main ends with 'leave; ret', it's entered with a frame like from a call;
+# the exit status is 1 if any quotient differs
+cat > "$work/start.S" <<'END'
+.text
+.global _start
+_enter:
+pushl %ebp
+movl %esp, %ebp
+jmp _main
+_start:
+call _enter
+movl $1, %eax
+xorl %ebx, %ebx
+cmpl $0, bad
+setne %bl
+int $0x80
+END
+
+failed=0
+for d in $divisors; do
+    dir="$work/d$d"
+    mkdir -p "$dir"
+    # a negative divisor is written as a difference, the folder makes it constant
+    [ "$d" -lt 0 ] && c="(0 - ${d#-})" || c=$d
+
+    # the element of array is loaded, so 'x div dv[0]' stays idivl
+    cat > "$dir/test.p" <<END
+program divide;
+var
+	x, bad: integer;
+	dv: array [0..0] of integer;
+begin
+	dv[0] := $c;
+	bad := 0;
+	for x := (0 - 2147483647) - 1 to 2147483647 do begin
+		if (x div $c) <> (x div dv[0]) then
+			bad := bad + 1;
+	end;
+end.
+END
+
+    start=$(date +%s%N)
+    set +e
+    (cd "$dir" && "$pc" -O2 > out.txt 2> err.txt \
+        && cat divide.S "$work/start.S" > p.S \
+        && as --32 p.S -o p.o && ld -m elf_i386 p.o -o p && ./p)
+    rc=$?
+    set -e
+    ms=$((($(date +%s%N) - start) / 1000000))
+
+    if [ $rc -ne 0 ] || grep -q '<E>\|Error' "$dir/out.txt" "$dir/err.txt"; then
+        printf '%-11s FAIL rc=%d\n' "$d" $rc
+        grep -h '<E>\|Error' "$dir/out.txt" "$dir/err.txt" | head -3
+        failed=1
+    else
+        printf '%-11s ok   %d.%03d s\n' "$d" $((ms / 1000)) $((ms % 1000))
+    fi
+done
+exit $failed